@@ -1,317 +0,0 @@
-/*
- * Multi-Site WAN with Triangular Topology and Redundancy
- *
- * Network Topology:
- *
- *                    HQ (n0)
- *                   /       \
- *                  /         \
- *           10.1.1.0/24    10.1.3.0/24 (Primary HQ-DC)
- *                /             \
- *               /               \
- *         Branch (n1) -------- DC (n2)
- *                  10.1.2.0/24
- *
- * - HQ (n0): 10.1.1.1, 10.1.3.1
- * - Branch (n1): 10.1.1.2, 10.1.2.1
- * - DC (n2): 10.1.2.2, 10.1.3.2
- * - All links: 5Mbps, 2ms delay
- * - Primary path HQ->DC: Direct (10.1.3.0/24)
- * - Backup path HQ->DC: Via Branch (HQ->Branch->DC)
- * - Link failure simulation at t=4s
- */
-
-#include "ns3/applications-module.h"
-#include "ns3/core-module.h"
-#include "ns3/flow-monitor-module.h"
-#include "ns3/internet-module.h"
-#include "ns3/mobility-module.h"
-#include "ns3/netanim-module.h"
-#include "ns3/network-module.h"
-#include "ns3/point-to-point-module.h"
-
-using namespace ns3;
-
-NS_LOG_COMPONENT_DEFINE("TriangularWANTopology");
-
-int
-main(int argc, char* argv[])
-{
-    // Enable logging
-    LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
-    LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
-
-    // Command line parameters
-    bool enableLinkFailure = true;
-    CommandLine cmd;
-    cmd.AddValue("enableLinkFailure", "Enable link failure at t=4s", enableLinkFailure);
-    cmd.Parse(argc, argv);
-
-    // Create three nodes: n0 (HQ), n1 (Branch), n2 (DC)
-    NodeContainer nodes;
-    nodes.Create(3);
-
-    Ptr<Node> n0 = nodes.Get(0); // HQ (Headquarters)
-    Ptr<Node> n1 = nodes.Get(1); // Branch Office
-    Ptr<Node> n2 = nodes.Get(2); // Data Center
-
-    // Create point-to-point links with same characteristics
-    PointToPointHelper p2p;
-    p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
-    p2p.SetChannelAttribute("Delay", StringValue("2ms"));
-
-    //  QUESTION 1: TOPOLOGY EXTENSION 
-    // Link 1: HQ (n0) <-> Branch (n1) - Network 1
-    NodeContainer link1Nodes(n0, n1);
-    NetDeviceContainer link1Devices = p2p.Install(link1Nodes);
-
-    // Link 2: Branch (n1) <-> DC (n2) - Network 2
-    NodeContainer link2Nodes(n1, n2);
-    NetDeviceContainer link2Devices = p2p.Install(link2Nodes);
-
-    // Link 3: HQ (n0) <-> DC (n2) - Network 3 (PRIMARY PATH)
-    NodeContainer link3Nodes(n0, n2);
-    NetDeviceContainer link3Devices = p2p.Install(link3Nodes);
-
-    // Install mobility model for NetAnim visualization
-    MobilityHelper mobility;
-    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mobility.Install(nodes);
-
-    // Set positions for triangular layout
-    Ptr<MobilityModel> mob0 = n0->GetObject<MobilityModel>();
-    Ptr<MobilityModel> mob1 = n1->GetObject<MobilityModel>();
-    Ptr<MobilityModel> mob2 = n2->GetObject<MobilityModel>();
-
-    mob0->SetPosition(Vector(10.0, 2.0, 0.0));  // HQ at top
-    mob1->SetPosition(Vector(5.0, 15.0, 0.0));  // Branch bottom-left
-    mob2->SetPosition(Vector(15.0, 15.0, 0.0)); // DC bottom-right
-
-    // Install Internet stack
-    InternetStackHelper stack;
-    stack.Install(nodes);
-
-    //  ASSIGN IP ADDRESSES 
-    // Network 1: HQ <-> Branch (10.1.1.0/24)
-    Ipv4AddressHelper address1;
-    address1.SetBase("10.1.1.0", "255.255.255.0");
-    Ipv4InterfaceContainer interfaces1 = address1.Assign(link1Devices);
-    // interfaces1.GetAddress(0) = 10.1.1.1 (HQ)
-    // interfaces1.GetAddress(1) = 10.1.1.2 (Branch)
-
-    // Network 2: Branch <-> DC (10.1.2.0/24)
-    Ipv4AddressHelper address2;
-    address2.SetBase("10.1.2.0", "255.255.255.0");
-    Ipv4InterfaceContainer interfaces2 = address2.Assign(link2Devices);
-    // interfaces2.GetAddress(0) = 10.1.2.1 (Branch)
-    // interfaces2.GetAddress(1) = 10.1.2.2 (DC)
-
-    // Network 3: HQ <-> DC (10.1.3.0/24) - PRIMARY PATH
-    Ipv4AddressHelper address3;
-    address3.SetBase("10.1.3.0", "255.255.255.0");
-    Ipv4InterfaceContainer interfaces3 = address3.Assign(link3Devices);
-    // interfaces3.GetAddress(0) = 10.1.3.1 (HQ)
-    // interfaces3.GetAddress(1) = 10.1.3.2 (DC)
-
-    //  QUESTION 2: STATIC ROUTING CONFIGURATION 
-
-    // Enable IP forwarding on Branch (n1) - acts as router
-    Ptr<Ipv4> ipv4Branch = n1->GetObject<Ipv4>();
-    ipv4Branch->SetAttribute("IpForward", BooleanValue(true));
-
-    Ipv4StaticRoutingHelper staticRoutingHelper;
-
-    // === Configure HQ (n0) Routing ===
-    Ptr<Ipv4StaticRouting> staticRoutingN0 =
-        staticRoutingHelper.GetStaticRouting(n0->GetObject<Ipv4>());
-
-    // Primary route to DC network (direct link, metric 0)
-    staticRoutingN0->AddNetworkRouteTo(Ipv4Address("10.1.2.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.3.2"), // Via DC direct
-                                       2,                        // Interface 2
-                                       0);                       // Metric 0 (primary)
-
-    // Backup route to DC network (via Branch, metric 10)
-    staticRoutingN0->AddNetworkRouteTo(Ipv4Address("10.1.2.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.1.2"), // Via Branch
-                                       1,                        // Interface 1
-                                       10);                      // Metric 10 (backup)
-
-    // === Configure Branch (n1) Routing ===
-    Ptr<Ipv4StaticRouting> staticRoutingN1 =
-        staticRoutingHelper.GetStaticRouting(n1->GetObject<Ipv4>());
-
-    // Route to HQ-DC network (10.1.3.0/24)
-    staticRoutingN1->AddNetworkRouteTo(Ipv4Address("10.1.3.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.2.2"), // Via DC
-                                       2);                       // Interface 2
-
-    staticRoutingN1->AddNetworkRouteTo(Ipv4Address("10.1.3.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.1.1"), // Via HQ
-                                       1);                       // Interface 1
-
-    // === Configure DC (n2) Routing ===
-    Ptr<Ipv4StaticRouting> staticRoutingN2 =
-        staticRoutingHelper.GetStaticRouting(n2->GetObject<Ipv4>());
-
-    // Primary route to HQ network (direct link, metric 0)
-    staticRoutingN2->AddNetworkRouteTo(Ipv4Address("10.1.1.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.3.1"), // Via HQ direct
-                                       2,                        // Interface 2
-                                       0);                       // Metric 0 (primary)
-
-    // Backup route to HQ network (via Branch, metric 10)
-    staticRoutingN2->AddNetworkRouteTo(Ipv4Address("10.1.1.0"),
-                                       Ipv4Mask("255.255.255.0"),
-                                       Ipv4Address("10.1.2.1"), // Via Branch
-                                       1,                        // Interface 1
-                                       10);                      // Metric 10 (backup)
-
-    // Print routing tables
-    Ptr<OutputStreamWrapper> routingStream =
-        Create<OutputStreamWrapper>("scratch/triangular-routing.routes", std::ios::out);
-    staticRoutingHelper.PrintRoutingTableAllAt(Seconds(1.0), routingStream);
-
-    std::cout << "\n========== NETWORK CONFIGURATION ==========\n";
-    std::cout << "HQ (n0):\n";
-    std::cout << "  - Interface 1: " << interfaces1.GetAddress(0) << " (to Branch)\n";
-    std::cout << "  - Interface 2: " << interfaces3.GetAddress(0) << " (to DC - PRIMARY)\n";
-    std::cout << "\nBranch (n1):\n";
-    std::cout << "  - Interface 1: " << interfaces1.GetAddress(1) << " (to HQ)\n";
-    std::cout << "  - Interface 2: " << interfaces2.GetAddress(0) << " (to DC)\n";
-    std::cout << "\nDC (n2):\n";
-    std::cout << "  - Interface 1: " << interfaces2.GetAddress(1) << " (to Branch)\n";
-    std::cout << "  - Interface 2: " << interfaces3.GetAddress(1) << " (to HQ - PRIMARY)\n";
-    std::cout << "===========================================\n\n";
-
-    //  APPLICATIONS 
-    // UDP Echo Server on DC (n2)
-    uint16_t port = 9;
-    UdpEchoServerHelper echoServer(port);
-    ApplicationContainer serverApps = echoServer.Install(n2);
-    serverApps.Start(Seconds(1.0));
-    serverApps.Stop(Seconds(15.0));
-
-    // UDP Echo Client on HQ (n0) targeting DC
-    UdpEchoClientHelper echoClient(interfaces2.GetAddress(1), port); // DC's IP
-    echoClient.SetAttribute("MaxPackets", UintegerValue(10));
-    echoClient.SetAttribute("Interval", TimeValue(Seconds(1.0)));
-    echoClient.SetAttribute("PacketSize", UintegerValue(1024));
-
-    ApplicationContainer clientApps = echoClient.Install(n0);
-    clientApps.Start(Seconds(2.0));
-    clientApps.Stop(Seconds(15.0));
-
-    //  QUESTION 3: PATH FAILURE SIMULATION 
-    if (enableLinkFailure)
-    {
-        Simulator::Schedule(Seconds(4.0), [&link3Devices]() {
-            std::cout << "\n*** LINK FAILURE: HQ-DC primary link DOWN at t=4s ***\n";
-            std::cout << "*** Traffic should now route via Branch (backup path) ***\n\n";
-
-            // Disable the primary HQ-DC link
-            Ptr<PointToPointNetDevice> dev0 =
-                DynamicCast<PointToPointNetDevice>(link3Devices.Get(0));
-            Ptr<PointToPointNetDevice> dev2 =
-                DynamicCast<PointToPointNetDevice>(link3Devices.Get(1));
-
-            dev0->SetAttribute("ReceiveEnable", BooleanValue(false));
-            dev2->SetAttribute("ReceiveEnable", BooleanValue(false));
-        });
-
-        // Re-enable link at t=10s to show recovery
-        Simulator::Schedule(Seconds(10.0), [&link3Devices]() {
-            std::cout << "\n*** LINK RECOVERY: HQ-DC primary link UP at t=10s ***\n";
-            std::cout << "*** Traffic should return to primary path ***\n\n";
-
-            Ptr<PointToPointNetDevice> dev0 =
-                DynamicCast<PointToPointNetDevice>(link3Devices.Get(0));
-            Ptr<PointToPointNetDevice> dev2 =
-                DynamicCast<PointToPointNetDevice>(link3Devices.Get(1));
-
-            dev0->SetAttribute("ReceiveEnable", BooleanValue(true));
-            dev2->SetAttribute("ReceiveEnable", BooleanValue(true));
-        });
-    }
-
-    //  FLOW MONITOR for latency measurement 
-    FlowMonitorHelper flowmon;
-    Ptr<FlowMonitor> monitor = flowmon.InstallAll();
-
-    //  NetAnim Configuration 
-    AnimationInterface anim("scratch/triangular-topology.xml");
-    anim.UpdateNodeDescription(n0, "HQ\n10.1.1.1\n10.1.3.1");
-    anim.UpdateNodeDescription(n1, "Branch\n10.1.1.2\n10.1.2.1");
-    anim.UpdateNodeDescription(n2, "DC\n10.1.2.2\n10.1.3.2");
-
-    anim.UpdateNodeColor(n0, 0, 255, 0);   // Green - HQ
-    anim.UpdateNodeColor(n1, 255, 255, 0); // Yellow - Branch
-    anim.UpdateNodeColor(n2, 0, 0, 255);   // Blue - DC
-
-    // Enable PCAP tracing
-    p2p.EnablePcapAll("scratch/triangular-topology");
-
-    // Run simulation
-    Simulator::Stop(Seconds(16.0));
-    Simulator::Run();
-
-    //  FLOW MONITOR STATISTICS 
-    monitor->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
-
-    std::cout << "\n========== FLOW STATISTICS ==========\n";
-    for (auto const& flow : stats)
-    {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flow.first);
-        std::cout << "Flow " << flow.first << " (" << t.sourceAddress << " -> "
-                  << t.destinationAddress << ")\n";
-        std::cout << "  Tx Packets: " << flow.second.txPackets << "\n";
-        std::cout << "  Rx Packets: " << flow.second.rxPackets << "\n";
-        std::cout << "  Lost Packets: " << flow.second.lostPackets << "\n";
-        if (flow.second.rxPackets > 0)
-        {
-            std::cout << "  Average Delay: "
-                      << flow.second.delaySum.GetSeconds() / flow.second.rxPackets << " s\n";
-            std::cout << "  Throughput: "
-                      << flow.second.rxBytes * 8.0 /
-                             (flow.second.timeLastRxPacket.GetSeconds() -
-                              flow.second.timeFirstTxPacket.GetSeconds()) /
-                             1000
-                      << " Kbps\n";
-        }
-        std::cout << "\n";
-    }
-    std::cout << "=====================================\n";
-
-    Simulator::Destroy();
-
-    std::cout << "\n========== SIMULATION COMPLETE ==========\n";
-    std::cout << "Animation: scratch/triangular-topology.xml\n";
-    std::cout << "Routing tables: scratch/triangular-routing.routes\n";
-    std::cout << "PCAP traces: scratch/triangular-topology-*.pcap\n";
-    std::cout << "=========================================\n";
-
-    // QUESTION 4 & 5 ANSWERS (printed for reference)
-    std::cout << "\n========== SCALABILITY ANALYSIS ==========\n";
-    std::cout << "Q4: For 10 sites in full mesh:\n";
-    std::cout << "  Static routes needed: 10 × (10-1) = 90 routes\n";
-    std::cout << "  Solution: Use OSPF (OspfHelper class in NS-3)\n";
-    std::cout << "    - Automatic neighbor discovery\n";
-    std::cout << "    - Dynamic path calculation\n";
-    std::cout << "    - Auto-failover without manual config\n\n";
-
-    std::cout << "Q5: Business Justification:\n";
-    std::cout << "  ✓ 99.9% uptime with redundant paths\n";
-    std::cout << "  ✓ Load balancing: 15Mbps total vs 5Mbps single link\n";
-    std::cout << "  ✓ MTTR reduced: 45min → 10min (deterministic paths)\n";
-    std::cout << "  ✓ ROI: 100:1 ($500/month vs $50K/hour downtime)\n";
-    std::cout << "=========================================\n";
-
-    return 0;
-}
\ No newline at end of file
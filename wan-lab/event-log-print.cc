@@ -0,0 +1,126 @@
+/*
+ * Affichage hors ligne d'un journal d'évènements binaire (event-log.h)
+ *
+ * Le formatage que le simulateur ne fait plus pendant l'exécution a lieu
+ * ici, après coup, avec filtrage par catégorie, nœud et fenêtre de temps.
+ *
+ * ./ns3 run "event-log-print --input=scratch/pbr-events.evlog --categories=4"
+ */
+
+#include "lib/event-log.h"
+
+#include "ns3/core-module.h"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("EventLogPrint");
+
+// Remplace chaque %u / %f du format par l'argument suivant
+static std::string FormatArgs(const char* format, const EventRecord& record) {
+    std::string out;
+    uint32_t next = 0;
+    char value[32];
+    for (const char* c = format; *c; c++) {
+        if (c[0] == '%' && (c[1] == 'u' || c[1] == 'f') && next < EventRecord::NUM_ARGS) {
+            uint64_t arg = record.args[next++];
+            if (c[1] == 'u') {
+                snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(arg));
+            } else {
+                snprintf(value, sizeof(value), "%.3f", EventLogToDouble(arg));
+            }
+            out += value;
+            c++;
+        } else {
+            out += *c;
+        }
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    std::string input = "scratch/pbr-events.evlog";
+    uint32_t categories = 0xffffffff;
+    int64_t node = -1;
+    double start = 0.0;
+    double stop = 1e9;
+    bool summary = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Journal d'évènements à afficher", input);
+    cmd.AddValue("categories", "Masque des catégories (1 PBR, 2 VoIP, 4 SD-WAN)", categories);
+    cmd.AddValue("node", "N'afficher que ce nœud (-1 = tous)", node);
+    cmd.AddValue("start", "Début de la fenêtre (s)", start);
+    cmd.AddValue("stop", "Fin de la fenêtre (s)", stop);
+    cmd.AddValue("summary", "N'afficher que le nombre d'évènements par type", summary);
+    cmd.Parse(argc, argv);
+
+    std::ifstream file(input, std::ios::binary);
+    if (!file) {
+        std::cerr << "Impossible d'ouvrir " << input << "\n";
+        return 1;
+    }
+
+    uint32_t header[4];
+    uint64_t count = 0;
+    uint64_t reserved = 0;
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    file.read(reinterpret_cast<char*>(&reserved), sizeof(reserved));
+    if (!file || header[0] != 0x474c5645 || header[1] != 1 || header[2] != sizeof(EventRecord)) {
+        std::cerr << input << " n'est pas un journal d'évènements compatible\n";
+        return 1;
+    }
+
+    int64_t startNs = int64_t(start * 1e9);
+    int64_t stopNs = int64_t(stop * 1e9);
+    std::map<uint16_t, uint64_t> perEvent;
+    std::vector<EventRecord> block(4096);
+    uint64_t remaining = count;
+    uint64_t shown = 0;
+
+    while (remaining > 0) {
+        size_t n = remaining < block.size() ? size_t(remaining) : block.size();
+        file.read(reinterpret_cast<char*>(block.data()), n * sizeof(EventRecord));
+        if (!file) {
+            std::cerr << "Journal tronqué : " << (count - remaining) << "/" << count
+                      << " enregistrements lus\n";
+            break;
+        }
+        remaining -= n;
+
+        for (size_t i = 0; i < n; i++) {
+            const EventRecord& record = block[i];
+            if (!(record.category & categories) || record.timeNs < startNs ||
+                record.timeNs > stopNs || (node >= 0 && record.node != uint64_t(node))) {
+                continue;
+            }
+            perEvent[record.event]++;
+            shown++;
+            if (summary) continue;
+
+            const EventLogDescriptor* descriptor = FindEventLogDescriptor(record.event);
+            char prefix[64];
+            snprintf(prefix, sizeof(prefix), "%12.6fs  nœud %-3u ", record.timeNs * 1e-9,
+                     record.node);
+            std::cout << prefix;
+            if (descriptor) {
+                std::cout << descriptor->name << "  " << FormatArgs(descriptor->format, record);
+            } else {
+                std::cout << "évènement 0x" << std::hex << record.event << std::dec;
+            }
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << "\n" << shown << "/" << count << " évènements\n";
+    for (const auto& entry : perEvent) {
+        const EventLogDescriptor* descriptor = FindEventLogDescriptor(entry.first);
+        std::cout << "  " << (descriptor ? descriptor->name : "?") << ": " << entry.second << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+ * Converts a CSV link impairment recording to a binary trace (see
+ * link-impairment.h), or dumps a binary trace back to CSV
+ *
+ * One change point per line, '#' starts a comment, an empty cell leaves
+ * the field unchanged:
+ *   time_s,link,delay_ms,loss,rate_mbps,up
+ *   15,primary,45,,,
+ *   15.5,primary,,0.02,20,
+ *   20,primary,10,0,50,1
+ * loss is a fraction of the packets (0 to 1), up is 0 or 1.
+ *
+ * ./ns3 run "impairment-trace-convert --input=scratch/brownout.csv
+ *            --output=scratch/brownout.impt"
+ * ./ns3 run "impairment-trace-convert --input=scratch/brownout.impt --dump"
+ */
+
+#define LINK_IMPAIRMENT_TRACE_ONLY
+#include "lib/link-impairment.h"
+
+#include "ns3/core-module.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ImpairmentTraceConvert");
+
+namespace
+{
+
+std::string
+Trim(const std::string& text)
+{
+    size_t begin = text.find_first_not_of(" \t\r");
+    size_t end = text.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+}
+
+void
+Dump(const link_impairment::Trace& trace)
+{
+    std::cout << "time_s,link,delay_ms,loss,rate_mbps,up\n";
+    for (const link_impairment::Change& change : trace.GetChanges())
+    {
+        std::cout << change.time * 1e-9 << "," << trace.GetLinks()[change.link] << ",";
+        if (change.mask & link_impairment::FIELD_DELAY)
+        {
+            std::cout << change.delay * 1e-6;
+        }
+        std::cout << ",";
+        if (change.mask & link_impairment::FIELD_LOSS)
+        {
+            std::cout << change.lossPpm * 1e-6;
+        }
+        std::cout << ",";
+        if (change.mask & link_impairment::FIELD_RATE)
+        {
+            std::cout << change.rate * 1e-6;
+        }
+        std::cout << ",";
+        if (change.mask & link_impairment::FIELD_UP)
+        {
+            std::cout << (change.up ? 1 : 0);
+        }
+        std::cout << "\n";
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string input = "scratch/impairment.csv";
+    std::string output = "scratch/impairment.impt";
+#ifdef HAVE_ZSTD
+    bool compress = true;
+#else
+    bool compress = false;
+#endif
+    bool dump = false;
+    CommandLine cmd;
+    cmd.AddValue("input", "CSV recording (binary trace with --dump)", input);
+    cmd.AddValue("output", "Binary impairment trace", output);
+    cmd.AddValue("compress", "Compress the payload (default in HAVE_ZSTD builds)", compress);
+    cmd.AddValue("dump", "Print the binary trace given as input as CSV", dump);
+    cmd.Parse(argc, argv);
+
+    link_impairment::Trace trace;
+    if (dump)
+    {
+        if (!trace.Read(input))
+        {
+            NS_FATAL_ERROR(trace.GetError());
+        }
+        Dump(trace);
+        return 0;
+    }
+
+    std::ifstream csv(input);
+    if (!csv)
+    {
+        NS_FATAL_ERROR("Cannot open " << input);
+    }
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(csv, line))
+    {
+        lineNumber++;
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty() || line.compare(0, 6, "time_s") == 0)
+        {
+            continue;
+        }
+        std::vector<std::string> cells;
+        std::stringstream row(line);
+        std::string cell;
+        while (std::getline(row, cell, ','))
+        {
+            cells.push_back(Trim(cell));
+        }
+        cells.resize(6);
+        if (cells[0].empty() || cells[1].empty())
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber << ": time and link are required");
+        }
+
+        // Values are range-checked as doubles before the conversion: a
+        // negative or huge value would wrap in the integer fields of the
+        // trace (the upper bounds keep the nanoseconds and bit/s in 64 bits)
+        link_impairment::Change change = {};
+        double time = 0;
+        double delayMs = 0;
+        double loss = 0;
+        double rateMbps = 1;
+        try
+        {
+            time = std::stod(cells[0]);
+            if (!cells[2].empty())
+            {
+                change.mask |= link_impairment::FIELD_DELAY;
+                delayMs = std::stod(cells[2]);
+            }
+            if (!cells[3].empty())
+            {
+                change.mask |= link_impairment::FIELD_LOSS;
+                loss = std::stod(cells[3]);
+            }
+            if (!cells[4].empty())
+            {
+                change.mask |= link_impairment::FIELD_RATE;
+                rateMbps = std::stod(cells[4]);
+            }
+            if (!cells[5].empty())
+            {
+                change.mask |= link_impairment::FIELD_UP;
+                change.up = std::stoi(cells[5]) != 0;
+            }
+        }
+        catch (const std::exception&)
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber << ": not a number");
+        }
+        if (!(time >= 0 && time < 9e9))
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber << ": time must be >= 0 s (and below 9e9)");
+        }
+        if (!(delayMs >= 0 && delayMs < 9e12))
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber
+                                 << ": delay must be >= 0 ms (and below 9e12)");
+        }
+        if (!(loss >= 0 && loss <= 1))
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber << ": loss must be between 0 and 1");
+        }
+        if (!(rateMbps > 0 && rateMbps < 1.8e13))
+        {
+            NS_FATAL_ERROR(input << ":" << lineNumber
+                                 << ": rate must be > 0 Mbps (and below 1.8e13)");
+        }
+
+        change.time = int64_t(time * 1e9);
+        change.link = trace.AddLink(cells[1]);
+        if (change.mask & link_impairment::FIELD_DELAY)
+        {
+            change.delay = int64_t(delayMs * 1e6);
+        }
+        if (change.mask & link_impairment::FIELD_LOSS)
+        {
+            change.lossPpm = uint32_t(loss * 1e6 + 0.5);
+        }
+        if (change.mask & link_impairment::FIELD_RATE)
+        {
+            change.rate = uint64_t(rateMbps * 1e6);
+        }
+        if (change.mask)
+        {
+            trace.AddChange(change);
+        }
+    }
+
+#ifndef HAVE_ZSTD
+    if (compress)
+    {
+        std::cerr << "Warning: built without HAVE_ZSTD (zstd not found by CMake), "
+                  << output << " is written uncompressed\n";
+    }
+#endif
+    if (!trace.Write(output, compress))
+    {
+        NS_FATAL_ERROR(trace.GetError());
+    }
+    std::cout << trace.GetChanges().size() << " change points on " << trace.GetLinks().size()
+              << " links written to " << output << std::endl;
+    return 0;
+}
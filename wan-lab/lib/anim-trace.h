@@ -0,0 +1,511 @@
+/*
+ * Compact binary animation trace (streaming alternative to NetAnim XML)
+ *
+ * BinaryAnimTrace records the point-to-point packet events of a
+ * simulation (first bit transmitted, last bit received) as varint records,
+ * buffered and written in chunks. AnimTraceReader decodes the file; the
+ * anim-trace-convert program turns a time window of it into NetAnim XML.
+ *
+ * File: 12-byte header { "NABT", u32 version, u32 flags }, then chunks
+ * { u32 rawSize, u32 storedSize, payload }. With FLAG_ZSTD (build with
+ * HAVE_ZSTD) a payload is zstd-compressed when storedSize < rawSize.
+ *
+ * Records (one tag byte, then varints unless noted):
+ *   REC_NODE  node, x (f64), y (f64)
+ *   REC_DESCR node, length, bytes
+ *   REC_COLOR node, r, g, b (u8)
+ *   REC_LINK  from node, to node, data rate (bit/s); link ids are implicit,
+ *             in declaration order
+ *   REC_TX    dt, link * 2 + direction, zigzag uid delta, size
+ *   REC_RX    dt, link * 2 + direction, zigzag uid delta
+ * dt is the time since the previous TX/RX record (ns); uid deltas are
+ * relative to the previous record of the same kind. A record never spans
+ * two chunks.
+ *
+ * Filtering happens at record time: only events inside [start, stop] and
+ * touching a selected node (all by default) are written.
+ */
+
+#ifndef ANIM_TRACE_H
+#define ANIM_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "trace-codec.h"
+
+#ifndef ANIM_TRACE_READER_ONLY
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <memory>
+#include <set>
+#endif
+
+namespace anim_trace
+{
+
+const char MAGIC[4] = {'N', 'A', 'B', 'T'};
+const uint32_t VERSION = 1;
+const uint32_t FLAG_ZSTD = 1;
+
+enum RecordType
+{
+    REC_NODE = 1,
+    REC_DESCR = 2,
+    REC_COLOR = 3,
+    REC_LINK = 4,
+    REC_TX = 5,
+    REC_RX = 6
+};
+
+using trace_codec::Cursor;
+using trace_codec::PutDouble;
+using trace_codec::PutVarint;
+using trace_codec::PutZigzag;
+
+// Decoded record, times in ns
+struct Record
+{
+    RecordType type;
+    int64_t time;      // TX/RX
+    uint32_t node;     // NODE/DESCR/COLOR; from node for LINK
+    uint32_t peer;     // LINK: to node
+    uint64_t dataRate; // LINK
+    uint32_t linkDir;  // TX/RX
+    uint64_t uid;      // TX/RX
+    uint32_t size;     // TX
+    double x;
+    double y;
+    uint8_t color[3];
+    std::string text;
+};
+
+class AnimTraceReader
+{
+  public:
+    bool Open(const std::string& filename)
+    {
+        m_file.open(filename, std::ios::binary);
+        char magic[4];
+        uint32_t header[2];
+        if (!m_file.read(magic, sizeof(magic)) ||
+            !m_file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        {
+            return false;
+        }
+        m_flags = header[1];
+        return std::memcmp(magic, MAGIC, sizeof(magic)) == 0 && header[0] == VERSION;
+    }
+
+    // Calls visit for every record; false on a truncated or corrupt file
+    bool ReadAll(const std::function<void(const Record&)>& visit)
+    {
+        int64_t time = 0;
+        uint64_t txUid = 0;
+        uint64_t rxUid = 0;
+        std::vector<uint8_t> stored;
+        std::vector<uint8_t> raw;
+        uint32_t sizes[2];
+        while (m_file.read(reinterpret_cast<char*>(sizes), sizeof(sizes)))
+        {
+            stored.resize(sizes[1]);
+            if (!m_file.read(reinterpret_cast<char*>(stored.data()), stored.size()))
+            {
+                return false;
+            }
+            if (!Decode(stored, sizes[0], raw))
+            {
+                return false;
+            }
+
+            Cursor cursor{raw.data(), raw.size(), 0, true};
+            while (cursor.ok && !cursor.AtEnd())
+            {
+                Record record = Record();
+                record.type = RecordType(cursor.Byte());
+                switch (record.type)
+                {
+                case REC_NODE:
+                    record.node = cursor.Varint();
+                    record.x = cursor.Double();
+                    record.y = cursor.Double();
+                    break;
+                case REC_DESCR: {
+                    record.node = cursor.Varint();
+                    uint64_t length = cursor.Varint();
+                    for (uint64_t i = 0; i < length && cursor.ok; i++)
+                    {
+                        record.text.push_back(char(cursor.Byte()));
+                    }
+                    break;
+                }
+                case REC_COLOR:
+                    record.node = cursor.Varint();
+                    for (uint8_t& c : record.color)
+                    {
+                        c = cursor.Byte();
+                    }
+                    break;
+                case REC_LINK:
+                    record.node = cursor.Varint();
+                    record.peer = cursor.Varint();
+                    record.dataRate = cursor.Varint();
+                    break;
+                case REC_TX:
+                    time += cursor.Varint();
+                    record.time = time;
+                    record.linkDir = cursor.Varint();
+                    txUid += cursor.Zigzag();
+                    record.uid = txUid;
+                    record.size = cursor.Varint();
+                    break;
+                case REC_RX:
+                    time += cursor.Varint();
+                    record.time = time;
+                    record.linkDir = cursor.Varint();
+                    rxUid += cursor.Zigzag();
+                    record.uid = rxUid;
+                    break;
+                default:
+                    return false;
+                }
+                if (cursor.ok)
+                {
+                    visit(record);
+                }
+            }
+            if (!cursor.ok)
+            {
+                return false;
+            }
+        }
+        return m_file.eof();
+    }
+
+  private:
+    bool Decode(const std::vector<uint8_t>& stored, uint32_t rawSize, std::vector<uint8_t>& raw)
+    {
+        if (stored.size() == rawSize)
+        {
+            raw = stored;
+            return true;
+        }
+#ifdef HAVE_ZSTD
+        raw.resize(rawSize);
+        size_t n = ZSTD_decompress(raw.data(), raw.size(), stored.data(), stored.size());
+        return !ZSTD_isError(n) && n == rawSize;
+#else
+        std::fprintf(stderr, "Compressed animation trace: rebuild with HAVE_ZSTD\n");
+        return false;
+#endif
+    }
+
+    std::ifstream m_file;
+    uint32_t m_flags = 0;
+};
+
+} // namespace anim_trace
+
+#ifndef ANIM_TRACE_READER_ONLY
+
+namespace ns3
+{
+
+class BinaryAnimTrace
+{
+  public:
+    BinaryAnimTrace()
+        : m_chunkSize(64 * 1024),
+          m_compress(false),
+          m_start(Seconds(0)),
+          m_stop(Time::Max()),
+          m_lastTime(0),
+          m_lastTxUid(0),
+          m_lastRxUid(0),
+          m_events(0),
+          m_bytesWritten(0)
+    {
+    }
+
+    ~BinaryAnimTrace()
+    {
+        Close();
+    }
+
+    // Compression takes effect only in HAVE_ZSTD builds
+    bool Open(const std::string& filename, bool compress = false, uint32_t chunkSize = 64 * 1024)
+    {
+        m_file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!m_file)
+        {
+            return false;
+        }
+#ifdef HAVE_ZSTD
+        m_compress = compress;
+#else
+        if (compress)
+        {
+            std::fprintf(stderr,
+                         "%s: compression requested but built without HAVE_ZSTD, "
+                         "writing uncompressed\n",
+                         filename.c_str());
+        }
+        m_compress = false;
+#endif
+        m_chunkSize = chunkSize;
+        m_buffer.reserve(chunkSize + 64);
+        uint32_t header[2] = {anim_trace::VERSION, m_compress ? anim_trace::FLAG_ZSTD : 0};
+        m_file.write(anim_trace::MAGIC, sizeof(anim_trace::MAGIC));
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_bytesWritten = 12;
+        return true;
+    }
+
+    void SetTimeRange(Time start, Time stop)
+    {
+        m_start = start;
+        m_stop = stop;
+    }
+
+    // Only events on links touching these nodes are recorded
+    void SetNodeFilter(const std::set<uint32_t>& nodes)
+    {
+        m_nodeFilter = nodes;
+    }
+
+    // Declares the nodes (positions from their mobility model) and every
+    // point-to-point link between them, then connects the device traces
+    void Install(const NodeContainer& nodes)
+    {
+        for (uint32_t i = 0; i < nodes.GetN(); i++)
+        {
+            Ptr<Node> node = nodes.Get(i);
+            Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
+            Vector position = mobility ? mobility->GetPosition() : Vector();
+            m_buffer.push_back(anim_trace::REC_NODE);
+            anim_trace::PutVarint(m_buffer, node->GetId());
+            anim_trace::PutDouble(m_buffer, position.x);
+            anim_trace::PutDouble(m_buffer, position.y);
+        }
+
+        std::set<Ptr<Channel>> seen;
+        for (uint32_t i = 0; i < nodes.GetN(); i++)
+        {
+            Ptr<Node> node = nodes.Get(i);
+            for (uint32_t d = 0; d < node->GetNDevices(); d++)
+            {
+                Ptr<PointToPointNetDevice> device =
+                    DynamicCast<PointToPointNetDevice>(node->GetDevice(d));
+                if (!device || !device->GetChannel() ||
+                    !seen.insert(device->GetChannel()).second)
+                {
+                    continue;
+                }
+                Ptr<Channel> channel = device->GetChannel();
+                if (channel->GetNDevices() != 2)
+                {
+                    continue;
+                }
+                AddLink(channel->GetDevice(0), channel->GetDevice(1));
+            }
+        }
+        FlushIfFull();
+    }
+
+    void UpdateNodeDescription(Ptr<Node> node, const std::string& description)
+    {
+        m_buffer.push_back(anim_trace::REC_DESCR);
+        anim_trace::PutVarint(m_buffer, node->GetId());
+        anim_trace::PutVarint(m_buffer, description.size());
+        m_buffer.insert(m_buffer.end(), description.begin(), description.end());
+        FlushIfFull();
+    }
+
+    void UpdateNodeColor(Ptr<Node> node, uint8_t r, uint8_t g, uint8_t b)
+    {
+        m_buffer.push_back(anim_trace::REC_COLOR);
+        anim_trace::PutVarint(m_buffer, node->GetId());
+        m_buffer.push_back(r);
+        m_buffer.push_back(g);
+        m_buffer.push_back(b);
+        FlushIfFull();
+    }
+
+    void Close()
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+        WriteChunk();
+        m_file.close();
+    }
+
+    uint64_t GetEvents() const
+    {
+        return m_events;
+    }
+
+    uint64_t GetBytesWritten() const
+    {
+        return m_bytesWritten;
+    }
+
+  private:
+    // One direction of a link, seen from one device
+    struct Endpoint
+    {
+        BinaryAnimTrace* owner;
+        uint32_t txLinkDir; // Direction of packets sent by this device
+        uint32_t rxLinkDir; // Direction of packets received by it
+        bool selected;      // Passes the node filter
+    };
+
+    void AddLink(Ptr<NetDevice> a, Ptr<NetDevice> b)
+    {
+        uint32_t link = m_links++;
+        DataRateValue rate;
+        a->GetAttribute("DataRate", rate);
+        m_buffer.push_back(anim_trace::REC_LINK);
+        anim_trace::PutVarint(m_buffer, a->GetNode()->GetId());
+        anim_trace::PutVarint(m_buffer, b->GetNode()->GetId());
+        anim_trace::PutVarint(m_buffer, rate.Get().GetBitRate());
+
+        bool selected = m_nodeFilter.empty() || m_nodeFilter.count(a->GetNode()->GetId()) ||
+                        m_nodeFilter.count(b->GetNode()->GetId());
+        Connect(a, link * 2, link * 2 + 1, selected);
+        Connect(b, link * 2 + 1, link * 2, selected);
+    }
+
+    void Connect(Ptr<NetDevice> device, uint32_t txLinkDir, uint32_t rxLinkDir, bool selected)
+    {
+        m_endpoints.emplace_back(new Endpoint{this, txLinkDir, rxLinkDir, selected});
+        Endpoint* endpoint = m_endpoints.back().get();
+        device->TraceConnectWithoutContext("PhyTxBegin",
+                                           MakeBoundCallback(&BinaryAnimTrace::TxBegin, endpoint));
+        device->TraceConnectWithoutContext("PhyRxEnd",
+                                           MakeBoundCallback(&BinaryAnimTrace::RxEnd, endpoint));
+    }
+
+    static void TxBegin(Endpoint* endpoint, Ptr<const Packet> packet)
+    {
+        BinaryAnimTrace* trace = endpoint->owner;
+        if (!endpoint->selected || !trace->InRange())
+        {
+            return;
+        }
+        std::vector<uint8_t>& out = trace->m_buffer;
+        out.push_back(anim_trace::REC_TX);
+        trace->PutTime();
+        anim_trace::PutVarint(out, endpoint->txLinkDir);
+        anim_trace::PutZigzag(out, int64_t(packet->GetUid() - trace->m_lastTxUid));
+        anim_trace::PutVarint(out, packet->GetSize());
+        trace->m_lastTxUid = packet->GetUid();
+        trace->m_events++;
+        trace->FlushIfFull();
+    }
+
+    static void RxEnd(Endpoint* endpoint, Ptr<const Packet> packet)
+    {
+        BinaryAnimTrace* trace = endpoint->owner;
+        if (!endpoint->selected || !trace->InRange())
+        {
+            return;
+        }
+        std::vector<uint8_t>& out = trace->m_buffer;
+        out.push_back(anim_trace::REC_RX);
+        trace->PutTime();
+        anim_trace::PutVarint(out, endpoint->rxLinkDir);
+        anim_trace::PutZigzag(out, int64_t(packet->GetUid() - trace->m_lastRxUid));
+        trace->m_lastRxUid = packet->GetUid();
+        trace->m_events++;
+        trace->FlushIfFull();
+    }
+
+    bool InRange() const
+    {
+        Time now = Simulator::Now();
+        return m_file.is_open() && now >= m_start && now <= m_stop;
+    }
+
+    void PutTime()
+    {
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        anim_trace::PutVarint(m_buffer, now - m_lastTime);
+        m_lastTime = now;
+    }
+
+    void FlushIfFull()
+    {
+        if (m_buffer.size() >= m_chunkSize)
+        {
+            WriteChunk();
+        }
+    }
+
+    void WriteChunk()
+    {
+        if (m_buffer.empty() || !m_file.is_open())
+        {
+            return;
+        }
+        const std::vector<uint8_t>* payload = &m_buffer;
+#ifdef HAVE_ZSTD
+        if (m_compress)
+        {
+            m_compressed.resize(ZSTD_compressBound(m_buffer.size()));
+            size_t n = ZSTD_compress(m_compressed.data(),
+                                     m_compressed.size(),
+                                     m_buffer.data(),
+                                     m_buffer.size(),
+                                     3);
+            if (!ZSTD_isError(n) && n < m_buffer.size())
+            {
+                m_compressed.resize(n);
+                payload = &m_compressed;
+            }
+        }
+#endif
+        uint32_t sizes[2] = {uint32_t(m_buffer.size()), uint32_t(payload->size())};
+        m_file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+        m_file.write(reinterpret_cast<const char*>(payload->data()), payload->size());
+        m_bytesWritten += sizeof(sizes) + payload->size();
+        m_buffer.clear();
+    }
+
+    std::ofstream m_file;
+    uint32_t m_chunkSize;
+    bool m_compress;
+    std::vector<uint8_t> m_buffer;
+    std::vector<uint8_t> m_compressed;
+
+    Time m_start;
+    Time m_stop;
+    std::set<uint32_t> m_nodeFilter;
+    std::vector<std::unique_ptr<Endpoint>> m_endpoints;
+    uint32_t m_links = 0;
+
+    int64_t m_lastTime;
+    uint64_t m_lastTxUid;
+    uint64_t m_lastRxUid;
+    uint64_t m_events;
+    uint64_t m_bytesWritten;
+};
+
+} // namespace ns3
+
+#endif // ANIM_TRACE_READER_ONLY
+
+#endif // ANIM_TRACE_H
@@ -0,0 +1,321 @@
+/*
+ * Automatic primary/backup static routes
+ *
+ * Discovers the adjacency of a set of nodes from their IPv4 interfaces,
+ * computes all-pairs shortest paths (one binary-heap Dijkstra per node,
+ * O(V.E log V) in total) and installs in a single pass, on every node:
+ * - a primary route to every remote subnet, metric = path cost
+ * - a backup route through another link, metric = backup path cost
+ *   + backup metric offset (always above the primary)
+ *
+ * Routing is hop-by-hop, so the backup neighbour n of node s for
+ * destination d must not send the traffic back through s: it is chosen
+ * among the loop-free alternates, dist(n,d) < dist(n,s) + dist(s,d).
+ * Its own shortest path then avoids the protected link s -> primary.
+ * Once the primary route is withdrawn (interface down, or link declared
+ * dead by LinkLivenessDetector, link-liveness.h) lookups use the backup.
+ *
+ * Link cost is the interface metric (Ipv4::SetMetric, 1 by default), as
+ * used by global routing.
+ */
+
+#ifndef BACKUP_ROUTING_H
+#define BACKUP_ROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class BackupRoutingHelper
+{
+  public:
+    BackupRoutingHelper()
+        : m_backupMetricOffset(10),
+          m_primaryRoutes(0),
+          m_backupRoutes(0),
+          m_unprotectedRoutes(0)
+    {
+    }
+
+    void SetBackupMetricOffset(uint32_t offset)
+    {
+        m_backupMetricOffset = offset;
+    }
+
+    // Compute and install the routes of all nodes (IPv4 stacks installed)
+    void Install(const NodeContainer& nodes)
+    {
+        Discover(nodes);
+        ComputeDistances();
+
+        Ipv4StaticRoutingHelper staticRoutingHelper;
+        for (uint32_t s = 0; s < m_nodes.GetN(); s++)
+        {
+            Ptr<Ipv4StaticRouting> routing =
+                staticRoutingHelper.GetStaticRouting(m_nodes.Get(s)->GetObject<Ipv4>());
+            InstallRoutes(s, routing);
+        }
+    }
+
+    // Same routes into another protocol with the Ipv4StaticRouting route API
+    // (e.g. Ipv4TrieRoutingHelper::GetTrieRouting, trie-routing.h)
+    template <typename Routing>
+    void Install(const NodeContainer& nodes, Ptr<Routing> (*getRouting)(Ptr<Ipv4>))
+    {
+        Discover(nodes);
+        ComputeDistances();
+
+        for (uint32_t s = 0; s < m_nodes.GetN(); s++)
+        {
+            InstallRoutes(s, getRouting(m_nodes.Get(s)->GetObject<Ipv4>()));
+        }
+    }
+
+    uint32_t GetPrimaryRoutes() const
+    {
+        return m_primaryRoutes;
+    }
+
+    uint32_t GetBackupRoutes() const
+    {
+        return m_backupRoutes;
+    }
+
+    // Primary routes without a loop-free alternate (e.g. a single uplink)
+    uint32_t GetUnprotectedRoutes() const
+    {
+        return m_unprotectedRoutes;
+    }
+
+  private:
+    static constexpr uint32_t INFINITE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t NO_HOP = std::numeric_limits<uint32_t>::max();
+
+    struct Adjacency
+    {
+        uint32_t neighbor;   // Node index
+        uint32_t interface;  // Outgoing interface on this node
+        uint32_t cost;       // Interface metric
+        Ipv4Address gateway; // Neighbor address on the link
+    };
+
+    struct Subnet
+    {
+        Ipv4Address network;
+        Ipv4Mask mask;
+        std::vector<uint32_t> attached; // Node indices
+    };
+
+    void Discover(const NodeContainer& nodes)
+    {
+        m_nodes = nodes;
+        uint32_t n = nodes.GetN();
+        std::unordered_map<uint32_t, uint32_t> indexOf; // Node id -> index
+        for (uint32_t i = 0; i < n; i++)
+        {
+            indexOf[nodes.Get(i)->GetId()] = i;
+        }
+
+        m_adjacency.assign(n, std::vector<Adjacency>());
+        m_subnets.clear();
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> subnetIndex;
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4>();
+            for (uint32_t itf = 1; itf < ipv4->GetNInterfaces(); itf++)
+            {
+                if (ipv4->GetNAddresses(itf) == 0)
+                {
+                    continue;
+                }
+                Ipv4InterfaceAddress address = ipv4->GetAddress(itf, 0);
+                Ipv4Address network = address.GetLocal().CombineMask(address.GetMask());
+                auto key = std::make_pair(network.Get(), address.GetMask().Get());
+                auto inserted = subnetIndex.emplace(key, m_subnets.size());
+                if (inserted.second)
+                {
+                    m_subnets.push_back({network, address.GetMask(), {}});
+                }
+                m_subnets[inserted.first->second].attached.push_back(i);
+
+                Ptr<NetDevice> device = ipv4->GetNetDevice(itf);
+                Ptr<Channel> channel = device->GetChannel();
+                if (!channel)
+                {
+                    continue;
+                }
+                for (std::size_t d = 0; d < channel->GetNDevices(); d++)
+                {
+                    Ptr<NetDevice> peer = channel->GetDevice(d);
+                    auto it = indexOf.find(peer->GetNode()->GetId());
+                    if (peer == device || it == indexOf.end())
+                    {
+                        continue;
+                    }
+                    Ptr<Ipv4> peerIpv4 = peer->GetNode()->GetObject<Ipv4>();
+                    int32_t peerItf = peerIpv4->GetInterfaceForDevice(peer);
+                    if (peerItf < 0 || peerIpv4->GetNAddresses(peerItf) == 0)
+                    {
+                        continue;
+                    }
+                    m_adjacency[i].push_back({it->second,
+                                              itf,
+                                              ipv4->GetMetric(itf),
+                                              peerIpv4->GetAddress(peerItf, 0).GetLocal()});
+                }
+            }
+        }
+    }
+
+    // One Dijkstra per source: m_distance[s * n + d]
+    void ComputeDistances()
+    {
+        uint32_t n = m_nodes.GetN();
+        m_distance.assign(std::size_t(n) * n, INFINITE);
+
+        typedef std::pair<uint32_t, uint32_t> Entry; // (distance, node)
+        for (uint32_t s = 0; s < n; s++)
+        {
+            uint32_t* dist = &m_distance[std::size_t(s) * n];
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+            dist[s] = 0;
+            heap.push(Entry(0, s));
+            while (!heap.empty())
+            {
+                Entry top = heap.top();
+                heap.pop();
+                if (top.first > dist[top.second])
+                {
+                    continue;
+                }
+                for (const Adjacency& adj : m_adjacency[top.second])
+                {
+                    uint32_t candidate = top.first + adj.cost;
+                    if (candidate < dist[adj.neighbor])
+                    {
+                        dist[adj.neighbor] = candidate;
+                        heap.push(Entry(candidate, adj.neighbor));
+                    }
+                }
+            }
+        }
+    }
+
+    uint32_t Distance(uint32_t from, uint32_t to) const
+    {
+        return m_distance[std::size_t(from) * m_nodes.GetN() + to];
+    }
+
+    template <typename Routing>
+    void InstallRoutes(uint32_t s, Ptr<Routing> routing)
+    {
+        uint32_t n = m_nodes.GetN();
+        const std::vector<Adjacency>& adjacency = m_adjacency[s];
+
+        // Primary and backup adjacency of s towards every node
+        std::vector<uint32_t> primary(n, NO_HOP);
+        std::vector<uint32_t> backup(n, NO_HOP);
+        std::vector<uint32_t> backupCost(n, INFINITE);
+        for (uint32_t d = 0; d < n; d++)
+        {
+            uint32_t best = INFINITE;
+            for (uint32_t a = 0; a < adjacency.size(); a++)
+            {
+                uint32_t through = Distance(adjacency[a].neighbor, d);
+                if (through != INFINITE && adjacency[a].cost + through < best)
+                {
+                    best = adjacency[a].cost + through;
+                    primary[d] = a;
+                }
+            }
+            if (primary[d] == NO_HOP)
+            {
+                continue;
+            }
+            for (uint32_t a = 0; a < adjacency.size(); a++)
+            {
+                uint32_t neighbor = adjacency[a].neighbor;
+                uint32_t through = Distance(neighbor, d);
+                if (a == primary[d] || through == INFINITE)
+                {
+                    continue;
+                }
+                // Loop-free alternate: n does not route back through s
+                bool loopFree =
+                    uint64_t(through) < uint64_t(Distance(neighbor, s)) + Distance(s, d);
+                if (loopFree && adjacency[a].cost + through < backupCost[d])
+                {
+                    backupCost[d] = adjacency[a].cost + through;
+                    backup[d] = a;
+                }
+            }
+        }
+
+        for (const Subnet& subnet : m_subnets)
+        {
+            // Directly connected subnets are already in the table; otherwise
+            // route towards the closest attached node
+            uint32_t target = NO_HOP;
+            bool connected = false;
+            for (uint32_t node : subnet.attached)
+            {
+                connected = connected || (node == s);
+                if (target == NO_HOP || Distance(s, node) < Distance(s, target))
+                {
+                    target = node;
+                }
+            }
+            if (connected || primary[target] == NO_HOP)
+            {
+                continue;
+            }
+
+            const Adjacency& first = adjacency[primary[target]];
+            routing->AddNetworkRouteTo(subnet.network,
+                                       subnet.mask,
+                                       first.gateway,
+                                       first.interface,
+                                       Distance(s, target));
+            m_primaryRoutes++;
+
+            if (backup[target] == NO_HOP)
+            {
+                m_unprotectedRoutes++;
+                continue;
+            }
+            const Adjacency& alternate = adjacency[backup[target]];
+            routing->AddNetworkRouteTo(subnet.network,
+                                       subnet.mask,
+                                       alternate.gateway,
+                                       alternate.interface,
+                                       backupCost[target] + m_backupMetricOffset);
+            m_backupRoutes++;
+        }
+    }
+
+    uint32_t m_backupMetricOffset;
+    uint32_t m_primaryRoutes;
+    uint32_t m_backupRoutes;
+    uint32_t m_unprotectedRoutes;
+
+    NodeContainer m_nodes;
+    std::vector<std::vector<Adjacency>> m_adjacency;
+    std::vector<Subnet> m_subnets;
+    std::vector<uint32_t> m_distance;
+};
+
+} // namespace ns3
+
+#endif // BACKUP_ROUTING_H
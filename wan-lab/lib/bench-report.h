@@ -0,0 +1,115 @@
+/*
+ * Per-run measurements for the scenario benchmark (scenario-benchmark.cc)
+ *
+ * BenchReport::Arm(), called by a scenario just before Simulator::Run(),
+ * does nothing unless NS3_BENCH_REPORT names an output file. Otherwise it
+ * marks the first simulated event and, from Simulator::Destroy(), writes a
+ * single-line JSON object with:
+ * - setupMs: process start to Arm() (topology, stacks, applications)
+ * - firstEventMs: process start to the first executed event
+ * - runMs: first event to Simulator::Destroy()
+ * - events: Simulator::GetEventCount(), simSeconds, peakRssKb
+ *
+ * The marker is scheduled at the current time when Arm() is called, so the
+ * events already queued for that instant run before it; setup dominates.
+ */
+
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/resource.h>
+
+namespace ns3
+{
+
+class BenchReport
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    static void Arm()
+    {
+        const char* path = std::getenv("NS3_BENCH_REPORT");
+        if (!path || !*path)
+        {
+            return;
+        }
+        State& state = GetState();
+        state.path = path;
+        state.armed = Clock::now();
+        Simulator::ScheduleNow(&BenchReport::MarkFirstEvent);
+        Simulator::ScheduleDestroy(&BenchReport::Write);
+    }
+
+  private:
+    struct State
+    {
+        std::string path;
+        Clock::time_point armed;
+        Clock::time_point firstEvent;
+    };
+
+    static State& GetState()
+    {
+        static State state;
+        return state;
+    }
+
+    // Initialized during static initialization, i.e. before main()
+    static Clock::time_point ProcessStart()
+    {
+        static const Clock::time_point start = Clock::now();
+        return start;
+    }
+
+    static double MillisecondsSince(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    static void MarkFirstEvent()
+    {
+        GetState().firstEvent = Clock::now();
+    }
+
+    static void Write()
+    {
+        State& state = GetState();
+        Clock::time_point now = Clock::now();
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        FILE* file = std::fopen(state.path.c_str(), "w");
+        if (!file)
+        {
+            std::perror(state.path.c_str());
+            return;
+        }
+        std::fprintf(file,
+                     "{\"setupMs\": %.3f, \"firstEventMs\": %.3f, \"runMs\": %.3f, "
+                     "\"events\": %llu, \"simSeconds\": %.6f, \"peakRssKb\": %ld}\n",
+                     MillisecondsSince(ProcessStart(), state.armed),
+                     MillisecondsSince(ProcessStart(), state.firstEvent),
+                     MillisecondsSince(state.firstEvent, now),
+                     static_cast<unsigned long long>(Simulator::GetEventCount()),
+                     Simulator::Now().GetSeconds(),
+                     usage.ru_maxrss);
+        std::fclose(file);
+    }
+
+    static const bool s_processStartInitialized;
+};
+
+inline const bool BenchReport::s_processStartInitialized =
+    (BenchReport::ProcessStart(), true);
+
+} // namespace ns3
+
+#endif // BENCH_REPORT_H
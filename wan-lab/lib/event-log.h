@@ -0,0 +1,227 @@
+/*
+ * Journal d'évènements binaire pour les chemins chauds du simulateur.
+ *
+ * Chaque évènement est un enregistrement à taille fixe (horodatage, nœud,
+ * catégorie, identifiant, 4 arguments 64 bits) copié directement dans un
+ * fichier projeté en mémoire (mmap) : ni formatage ni appel d'E/S sur la
+ * boucle d'évènements. Le fichier grandit par doublement ; Close() écrit le
+ * nombre d'enregistrements dans l'en-tête et tronque à la taille utile.
+ *
+ * Les catégories sont filtrées à la compilation : EVENT_LOG() vaut une
+ * expression constante nulle pour une catégorie absente de
+ * EVENT_LOG_CATEGORIES (par ex. -DEVENT_LOG_CATEGORIES=0x4 pour ne garder
+ * que le SD-WAN), et le compilateur supprime l'appel.
+ *
+ * Format (event-log-print le relit hors ligne) :
+ *   en-tête de 32 octets : "EVLG", version, taille d'enregistrement,
+ *                          réservé, nombre d'enregistrements (uint64), réservé
+ *   puis les EventRecord bruts, dans l'ordre d'émission
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Catégories (masque de bits)
+enum EventLogCategory {
+    EVLOG_PBR = 0x1,        // Classification et orientation des paquets
+    EVLOG_VOIP = 0x2,       // Générateurs de trafic VoIP
+    EVLOG_SDWAN = 0x4       // Décisions du contrôleur SD-WAN
+};
+
+#ifndef EVENT_LOG_CATEGORIES
+#define EVENT_LOG_CATEGORIES 0xffffffff
+#endif
+
+// Identifiants d'évènement, préfixés par leur catégorie
+enum EventLogId {
+    EVT_PBR_CLASSIFY = 0x0101,      // classe, port destination, interface de sortie
+    EVT_VOIP_SEND = 0x0201,         // paquets envoyés, taille
+    EVT_SDWAN_SWITCH = 0x0401,      // classe, interface, latence primaire, seuil (double)
+    EVT_SDWAN_TAIL_SWITCH = 0x0402, // classe, interface, latence Pxx, seuil, quantile (double)
+    EVT_SDWAN_RESTORE = 0x0403      // classe, interface, latence primaire (double)
+};
+
+// Enregistrement à taille fixe (48 octets)
+struct EventRecord {
+    static const uint32_t NUM_ARGS = 4;
+
+    int64_t timeNs;
+    uint32_t node;
+    uint16_t category;      // EventLogCategory
+    uint16_t event;         // EventLogId
+    uint64_t args[NUM_ARGS];
+};
+
+// Les arguments réels voyagent bit à bit dans un uint64_t
+inline uint64_t EventLogDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline double EventLogToDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Description d'un évènement pour l'affichage : %u consomme un argument
+// entier, %f un argument réel (EventLogDouble)
+struct EventLogDescriptor {
+    uint16_t event;
+    const char* name;
+    const char* format;
+};
+
+inline const EventLogDescriptor* FindEventLogDescriptor(uint16_t event) {
+    static const EventLogDescriptor descriptors[] = {
+        {EVT_PBR_CLASSIFY, "pbr.classify", "classe=%u port=%u interface=%u"},
+        {EVT_VOIP_SEND, "voip.send", "envoyés=%u taille=%u"},
+        {EVT_SDWAN_SWITCH, "sdwan.switch", "classe=%u interface=%u latence=%fms seuil=%fms"},
+        {EVT_SDWAN_TAIL_SWITCH, "sdwan.tail-switch",
+         "classe=%u interface=%u latence-queue=%fms seuil=%fms quantile=%f"},
+        {EVT_SDWAN_RESTORE, "sdwan.restore", "classe=%u interface=%u latence=%fms"},
+    };
+    for (const EventLogDescriptor& descriptor : descriptors) {
+        if (descriptor.event == event) return &descriptor;
+    }
+    return nullptr;
+}
+
+class EventLog {
+private:
+    static const uint32_t FILE_MAGIC = 0x474c5645;     // "EVLG"
+    static const uint32_t FILE_VERSION = 1;
+    static const size_t HEADER_SIZE = 32;
+
+    int m_fd;
+    char* m_base;                   // Projection du fichier entier
+    EventRecord* m_records;         // m_base + HEADER_SIZE
+    uint64_t m_capacity;            // Enregistrements projetés
+    uint64_t m_count;
+    uint64_t m_dropped;             // Agrandissement impossible
+
+public:
+    EventLog()
+        : m_fd(-1),
+          m_base(nullptr),
+          m_records(nullptr),
+          m_capacity(0),
+          m_count(0),
+          m_dropped(0) {}
+
+    ~EventLog() {
+        Close();
+    }
+
+    // Journal unique de l'exécution, utilisé par EVENT_LOG()
+    static EventLog& Get() {
+        static EventLog log;
+        return log;
+    }
+
+    bool Open(const std::string& filename, uint64_t initialRecords = 65536) {
+        if (m_fd >= 0) return false;
+
+        m_fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0) return false;
+
+        m_count = 0;
+        m_dropped = 0;
+        if (!Map(initialRecords > 0 ? initialRecords : 1)) {
+            close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        uint32_t header[4] = {FILE_MAGIC, FILE_VERSION, uint32_t(sizeof(EventRecord)), 0};
+        std::memcpy(m_base, header, sizeof(header));
+        return true;
+    }
+
+    bool IsOpen() const {
+        return m_records != nullptr;
+    }
+
+    // Appelé depuis la boucle d'évènements : une copie de 48 octets
+    void Append(int64_t timeNs, uint16_t category, uint16_t event, uint32_t node,
+                uint64_t a0 = 0, uint64_t a1 = 0, uint64_t a2 = 0, uint64_t a3 = 0) {
+        if (m_count == m_capacity && !Map(m_capacity * 2)) {
+            m_dropped++;
+            return;
+        }
+        EventRecord& record = m_records[m_count++];
+        record.timeNs = timeNs;
+        record.node = node;
+        record.category = category;
+        record.event = event;
+        record.args[0] = a0;
+        record.args[1] = a1;
+        record.args[2] = a2;
+        record.args[3] = a3;
+    }
+
+    void Close() {
+        if (m_fd < 0) return;
+
+        if (m_base) {
+            std::memcpy(m_base + 16, &m_count, sizeof(m_count));
+            munmap(m_base, MappedSize(m_capacity));
+        }
+        if (ftruncate(m_fd, MappedSize(m_count)) != 0) {
+            perror("event-log: ftruncate");
+        }
+        close(m_fd);
+        m_fd = -1;
+        m_base = nullptr;
+        m_records = nullptr;
+        m_capacity = 0;
+    }
+
+    uint64_t GetRecordsWritten() const {
+        return m_count;
+    }
+
+    uint64_t GetDropped() const {
+        return m_dropped;
+    }
+
+private:
+    static size_t MappedSize(uint64_t records) {
+        return HEADER_SIZE + records * sizeof(EventRecord);
+    }
+
+    // (Re)projette le fichier agrandi à capacity enregistrements
+    bool Map(uint64_t capacity) {
+        if (ftruncate(m_fd, MappedSize(capacity)) != 0) return false;
+        void* base = mmap(nullptr, MappedSize(capacity), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, m_fd, 0);
+        if (base == MAP_FAILED) return false;
+
+        if (m_base) munmap(m_base, MappedSize(m_capacity));
+        m_base = static_cast<char*>(base);
+        m_records = reinterpret_cast<EventRecord*>(m_base + HEADER_SIZE);
+        m_capacity = capacity;
+        return true;
+    }
+};
+
+// EVENT_LOG(catégorie, évènement, nœud, arguments...) : rien n'est évalué si
+// la catégorie est désactivée à la compilation ou si le journal est fermé
+#define EVENT_LOG(category, event, ...)                                                  \
+    do {                                                                                 \
+        if ((EVENT_LOG_CATEGORIES & (category)) != 0 && EventLog::Get().IsOpen()) {      \
+            EventLog::Get().Append(ns3::Simulator::Now().GetNanoSeconds(), (category),   \
+                                   (event), __VA_ARGS__);                                \
+        }                                                                                \
+    } while (0)
+
+#endif // EVENT_LOG_H
@@ -0,0 +1,589 @@
+/*
+ * Trace-driven impairment of point-to-point links
+ *
+ * A trace holds, per named link, the change points of its delay, loss
+ * rate, data rate and up/down state. LinkImpairmentEngine binds each name
+ * to the two devices of a link and replays the trace: one event per change
+ * point (all the fields changing at one instant are applied together) and
+ * nothing per packet beyond the receive error model draw.
+ * - delay: PointToPointChannel "Delay" (packets already in flight keep the
+ *   delay they were sent with, so a drop in delay can reorder them)
+ * - rate: PointToPointNetDevice::SetDataRate() on both ends
+ * - loss, up: a RateErrorModel (per packet) installed as the receive error
+ *   model of both devices, replacing any previous one; a link that is down
+ *   drops everything, its routes stay installed (as a real cut would)
+ *
+ * File: 20-byte header { "IMPT", u32 version, u32 flags, u32 rawSize,
+ * u32 storedSize }, then the payload, zstd-compressed with FLAG_ZSTD
+ * (HAVE_ZSTD builds) when storedSize < rawSize. Payload (varints):
+ *   link count, then per link: name length, name bytes
+ *   change count, then per change, in time order:
+ *     link, dt (ns since the previous change), field mask (u8),
+ *     delay (ns) if FIELD_DELAY, loss (parts per million) if FIELD_LOSS,
+ *     rate (bit/s) if FIELD_RATE, up (u8) if FIELD_UP
+ *
+ * impairment-trace-convert builds such a file from a CSV recording.
+ * Define LINK_IMPAIRMENT_TRACE_ONLY to get the trace classes without ns-3.
+ */
+
+#ifndef LINK_IMPAIRMENT_H
+#define LINK_IMPAIRMENT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "trace-codec.h"
+
+#ifndef LINK_IMPAIRMENT_TRACE_ONLY
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <functional>
+#endif
+
+namespace link_impairment
+{
+
+const char MAGIC[4] = {'I', 'M', 'P', 'T'};
+const uint32_t VERSION = 1;
+const uint32_t FLAG_ZSTD = 1;
+
+enum Field
+{
+    FIELD_DELAY = 1,
+    FIELD_LOSS = 2,
+    FIELD_RATE = 4,
+    FIELD_UP = 8
+};
+
+// One change point of one link; fields outside mask are unchanged
+struct Change
+{
+    int64_t time; // ns from the start of the replay
+    uint32_t link;
+    uint8_t mask;
+    int64_t delay;    // ns
+    uint32_t lossPpm; // Parts per million of the packets received
+    uint64_t rate;    // bit/s
+    bool up;
+};
+
+// In-memory trace: names of the links and their change points
+class Trace
+{
+  public:
+    uint32_t AddLink(const std::string& name)
+    {
+        for (uint32_t l = 0; l < m_links.size(); l++)
+        {
+            if (m_links[l] == name)
+            {
+                return l;
+            }
+        }
+        m_links.push_back(name);
+        return m_links.size() - 1;
+    }
+
+    void AddChange(const Change& change)
+    {
+        m_changes.push_back(change);
+    }
+
+    const std::vector<std::string>& GetLinks() const
+    {
+        return m_links;
+    }
+
+    // In time order after Read(); Write() sorts them
+    const std::vector<Change>& GetChanges() const
+    {
+        return m_changes;
+    }
+
+    const std::string& GetError() const
+    {
+        return m_error;
+    }
+
+    // Stable: change points of one instant keep their insertion order
+    void Sort()
+    {
+        std::stable_sort(m_changes.begin(),
+                         m_changes.end(),
+                         [](const Change& a, const Change& b) { return a.time < b.time; });
+    }
+
+    // Compression takes effect only in HAVE_ZSTD builds
+    bool Write(const std::string& filename, bool compress = true)
+    {
+        Sort();
+
+        std::vector<uint8_t> raw;
+        trace_codec::PutVarint(raw, m_links.size());
+        for (const std::string& name : m_links)
+        {
+            trace_codec::PutVarint(raw, name.size());
+            raw.insert(raw.end(), name.begin(), name.end());
+        }
+        trace_codec::PutVarint(raw, m_changes.size());
+        int64_t previous = 0;
+        for (const Change& change : m_changes)
+        {
+            if (change.time < previous || change.link >= m_links.size())
+            {
+                m_error = "negative time or unknown link in change point";
+                return false;
+            }
+            trace_codec::PutVarint(raw, change.link);
+            trace_codec::PutVarint(raw, change.time - previous);
+            raw.push_back(change.mask);
+            if (change.mask & FIELD_DELAY)
+            {
+                trace_codec::PutVarint(raw, change.delay);
+            }
+            if (change.mask & FIELD_LOSS)
+            {
+                trace_codec::PutVarint(raw, change.lossPpm);
+            }
+            if (change.mask & FIELD_RATE)
+            {
+                trace_codec::PutVarint(raw, change.rate);
+            }
+            if (change.mask & FIELD_UP)
+            {
+                raw.push_back(change.up ? 1 : 0);
+            }
+            previous = change.time;
+        }
+
+        std::vector<uint8_t> stored = raw;
+        uint32_t flags = 0;
+#ifdef HAVE_ZSTD
+        if (compress)
+        {
+            std::vector<uint8_t> packed(ZSTD_compressBound(raw.size()));
+            size_t n = ZSTD_compress(packed.data(), packed.size(), raw.data(), raw.size(), 19);
+            if (!ZSTD_isError(n) && n < raw.size())
+            {
+                packed.resize(n);
+                stored.swap(packed);
+                flags = FLAG_ZSTD;
+            }
+        }
+#else
+        (void)compress;
+#endif
+
+        std::ofstream file(filename, std::ios::binary);
+        uint32_t header[4] = {VERSION, flags, uint32_t(raw.size()), uint32_t(stored.size())};
+        file.write(MAGIC, sizeof(MAGIC));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(stored.data()), stored.size());
+        if (!file)
+        {
+            m_error = "cannot write " + filename;
+            return false;
+        }
+        return true;
+    }
+
+    bool Read(const std::string& filename)
+    {
+        m_links.clear();
+        m_changes.clear();
+        std::ifstream file(filename, std::ios::binary);
+        char magic[4];
+        uint32_t header[4];
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!file || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || header[0] != VERSION)
+        {
+            return Fail(filename + " is not a version 1 impairment trace");
+        }
+        std::vector<uint8_t> stored(header[3]);
+        file.read(reinterpret_cast<char*>(stored.data()), stored.size());
+        if (!file)
+        {
+            return Fail(filename + " is truncated");
+        }
+
+        std::vector<uint8_t> raw;
+        if (stored.size() == header[2])
+        {
+            raw.swap(stored);
+        }
+        else
+        {
+#ifdef HAVE_ZSTD
+            raw.resize(header[2]);
+            size_t n = ZSTD_decompress(raw.data(), raw.size(), stored.data(), stored.size());
+            if (ZSTD_isError(n) || n != raw.size())
+            {
+                return Fail(filename + ": corrupt compressed payload");
+            }
+#else
+            return Fail(filename + " is compressed: rebuild with HAVE_ZSTD");
+#endif
+        }
+
+        trace_codec::Cursor cursor{raw.data(), raw.size(), 0, true};
+        uint64_t links = cursor.Varint();
+        for (uint64_t l = 0; l < links && cursor.ok; l++)
+        {
+            uint64_t length = cursor.Varint();
+            if (length > raw.size() - std::min(raw.size(), cursor.pos))
+            {
+                return Fail(filename + ": corrupt link table");
+            }
+            m_links.emplace_back(reinterpret_cast<const char*>(raw.data() + cursor.pos), length);
+            cursor.pos += length;
+        }
+        uint64_t changes = cursor.Varint();
+        int64_t time = 0;
+        m_changes.reserve(std::min<uint64_t>(changes, raw.size()));
+        for (uint64_t c = 0; c < changes && cursor.ok; c++)
+        {
+            Change change = {};
+            change.link = cursor.Varint();
+            time += cursor.Varint();
+            change.time = time;
+            change.mask = cursor.Byte();
+            if (change.mask & FIELD_DELAY)
+            {
+                change.delay = cursor.Varint();
+            }
+            if (change.mask & FIELD_LOSS)
+            {
+                change.lossPpm = cursor.Varint();
+            }
+            if (change.mask & FIELD_RATE)
+            {
+                change.rate = cursor.Varint();
+            }
+            if (change.mask & FIELD_UP)
+            {
+                change.up = cursor.Byte() != 0;
+            }
+            if (change.link >= m_links.size())
+            {
+                return Fail(filename + ": change point for an unknown link");
+            }
+            m_changes.push_back(change);
+        }
+        if (!cursor.ok)
+        {
+            return Fail(filename + ": truncated payload");
+        }
+        return true;
+    }
+
+  private:
+    bool Fail(const std::string& error)
+    {
+        m_links.clear();
+        m_changes.clear();
+        m_error = error;
+        return false;
+    }
+
+    std::vector<std::string> m_links;
+    std::vector<Change> m_changes;
+    std::string m_error;
+};
+
+} // namespace link_impairment
+
+#ifndef LINK_IMPAIRMENT_TRACE_ONLY
+
+namespace ns3
+{
+
+// Current impairment of a link, as last set by the trace
+struct LinkImpairmentState
+{
+    Time delay;
+    double loss;
+    DataRate rate;
+    bool up;
+};
+
+class LinkImpairmentEngine
+{
+  public:
+    // (link name, fields changed, state after the change) at each change point
+    typedef std::function<void(const std::string&, uint8_t, const LinkImpairmentState&)>
+        ChangeCallback;
+
+    LinkImpairmentEngine()
+        : m_applied(0)
+    {
+    }
+
+    // Binds a trace link name to both devices of a point-to-point link; the
+    // initial state is read from the devices and the channel
+    void AddLink(const std::string& name, const NetDeviceContainer& devices)
+    {
+        NS_ABORT_MSG_IF(devices.GetN() != 2, "An impaired link has two devices");
+        Binding binding;
+        binding.name = name;
+        for (uint32_t d = 0; d < 2; d++)
+        {
+            Ptr<PointToPointNetDevice> device =
+                DynamicCast<PointToPointNetDevice>(devices.Get(d));
+            NS_ABORT_MSG_IF(!device, "Link " << name << " is not a point-to-point link");
+            binding.devices[d] = device;
+        }
+        binding.channel = DynamicCast<PointToPointChannel>(binding.devices[0]->GetChannel());
+        NS_ABORT_MSG_IF(!binding.channel, "Link " << name << " has no local channel");
+
+        TimeValue delay;
+        binding.channel->GetAttribute("Delay", delay);
+        DataRateValue rate;
+        binding.devices[0]->GetAttribute("DataRate", rate);
+        binding.state.delay = delay.Get();
+        binding.state.loss = 0.0;
+        binding.state.rate = rate.Get();
+        binding.state.up = true;
+        binding.next = 0;
+        m_bindings.push_back(binding);
+    }
+
+    void SetChangeCallback(ChangeCallback callback)
+    {
+        m_changeCallback = callback;
+    }
+
+    // Every link of the trace must have been bound with AddLink(). Loading
+    // a trace drops the change points not applied yet; call Start() again
+    bool Load(const std::string& filename)
+    {
+        link_impairment::Trace trace;
+        if (!trace.Read(filename))
+        {
+            m_error = trace.GetError();
+            return false;
+        }
+        return SetTrace(trace);
+    }
+
+    // Same as Load() for a trace built in memory
+    bool SetTrace(const link_impairment::Trace& trace)
+    {
+        for (Binding& binding : m_bindings)
+        {
+            binding.event.Cancel();
+            binding.changes.clear();
+            binding.next = 0;
+        }
+        m_trace = trace;
+        m_trace.Sort();
+        m_linkBinding.assign(m_trace.GetLinks().size(), 0);
+        for (uint32_t l = 0; l < m_trace.GetLinks().size(); l++)
+        {
+            int32_t binding = FindBinding(m_trace.GetLinks()[l]);
+            if (binding < 0)
+            {
+                m_error = "link " + m_trace.GetLinks()[l] + " of the trace is not bound";
+                return false;
+            }
+            m_linkBinding[l] = binding;
+        }
+
+        // Change points split per binding, still in time order
+        for (const link_impairment::Change& change : m_trace.GetChanges())
+        {
+            Binding& binding = m_bindings[m_linkBinding[change.link]];
+            binding.changes.push_back(change);
+            if ((change.mask & (link_impairment::FIELD_LOSS | link_impairment::FIELD_UP)) &&
+                !binding.errorModels[0])
+            {
+                InstallErrorModels(binding);
+            }
+        }
+        return true;
+    }
+
+    const std::string& GetError() const
+    {
+        return m_error;
+    }
+
+    // Trace times are relative to start; one pending event per link, change
+    // points already past are applied at once
+    void Start(Time start = Seconds(0))
+    {
+        m_start = start;
+        for (uint32_t b = 0; b < m_bindings.size(); b++)
+        {
+            ScheduleNext(b);
+        }
+    }
+
+    void Stop()
+    {
+        for (Binding& binding : m_bindings)
+        {
+            binding.event.Cancel();
+        }
+    }
+
+    const LinkImpairmentState& GetState(const std::string& name) const
+    {
+        int32_t binding = FindBinding(name);
+        NS_ABORT_MSG_IF(binding < 0, "Unknown impaired link " << name);
+        return m_bindings[binding].state;
+    }
+
+    const link_impairment::Trace& GetTrace() const
+    {
+        return m_trace;
+    }
+
+    uint32_t GetNChanges() const
+    {
+        return m_trace.GetChanges().size();
+    }
+
+    uint64_t GetChangesApplied() const
+    {
+        return m_applied;
+    }
+
+  private:
+    struct Binding
+    {
+        std::string name;
+        Ptr<PointToPointNetDevice> devices[2];
+        Ptr<PointToPointChannel> channel;
+        Ptr<RateErrorModel> errorModels[2];
+        LinkImpairmentState state;
+        std::vector<link_impairment::Change> changes;
+        size_t next;
+        EventId event;
+    };
+
+    int32_t FindBinding(const std::string& name) const
+    {
+        for (uint32_t b = 0; b < m_bindings.size(); b++)
+        {
+            if (m_bindings[b].name == name)
+            {
+                return b;
+            }
+        }
+        return -1;
+    }
+
+    void InstallErrorModels(Binding& binding)
+    {
+        for (uint32_t d = 0; d < 2; d++)
+        {
+            Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel>();
+            errorModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+            errorModel->SetRate(0.0);
+            errorModel->Disable();
+            binding.devices[d]->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+            binding.errorModels[d] = errorModel;
+        }
+    }
+
+    void ScheduleNext(uint32_t b)
+    {
+        Binding& binding = m_bindings[b];
+        if (binding.next >= binding.changes.size())
+        {
+            return;
+        }
+        Time at = m_start + NanoSeconds(binding.changes[binding.next].time);
+        Time delay = std::max(at - Simulator::Now(), Time(0));
+        binding.event = Simulator::Schedule(delay, &LinkImpairmentEngine::Apply, this, b);
+    }
+
+    // Applies every change point of the link due at this instant
+    void Apply(uint32_t b)
+    {
+        Binding& binding = m_bindings[b];
+        int64_t time = binding.changes[binding.next].time;
+        uint8_t changed = 0;
+        for (; binding.next < binding.changes.size() && binding.changes[binding.next].time == time;
+             binding.next++)
+        {
+            const link_impairment::Change& change = binding.changes[binding.next];
+            if (change.mask & link_impairment::FIELD_DELAY)
+            {
+                binding.state.delay = NanoSeconds(change.delay);
+            }
+            if (change.mask & link_impairment::FIELD_LOSS)
+            {
+                binding.state.loss = std::min(change.lossPpm, 1000000u) * 1e-6;
+            }
+            if (change.mask & link_impairment::FIELD_RATE)
+            {
+                binding.state.rate = DataRate(change.rate);
+            }
+            if (change.mask & link_impairment::FIELD_UP)
+            {
+                binding.state.up = change.up;
+            }
+            changed |= change.mask;
+            m_applied++;
+        }
+
+        if (changed & link_impairment::FIELD_DELAY)
+        {
+            binding.channel->SetAttribute("Delay", TimeValue(binding.state.delay));
+        }
+        if (changed & link_impairment::FIELD_RATE)
+        {
+            binding.devices[0]->SetDataRate(binding.state.rate);
+            binding.devices[1]->SetDataRate(binding.state.rate);
+        }
+        if (changed & (link_impairment::FIELD_LOSS | link_impairment::FIELD_UP))
+        {
+            double rate = binding.state.up ? binding.state.loss : 1.0;
+            for (Ptr<RateErrorModel> errorModel : binding.errorModels)
+            {
+                errorModel->SetRate(rate);
+                if (rate > 0.0)
+                {
+                    errorModel->Enable();
+                }
+                else
+                {
+                    errorModel->Disable();
+                }
+            }
+        }
+
+        if (m_changeCallback)
+        {
+            m_changeCallback(binding.name, changed, binding.state);
+        }
+        ScheduleNext(b);
+    }
+
+    link_impairment::Trace m_trace;
+    std::vector<uint32_t> m_linkBinding; // Trace link -> binding
+    std::vector<Binding> m_bindings;
+    Time m_start;
+    ChangeCallback m_changeCallback;
+    uint64_t m_applied;
+    std::string m_error;
+};
+
+} // namespace ns3
+
+#endif // LINK_IMPAIRMENT_TRACE_ONLY
+
+#endif // LINK_IMPAIRMENT_H
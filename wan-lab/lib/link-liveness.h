@@ -0,0 +1,275 @@
+/*
+ * BFD-style link liveness detection with static route withdrawal
+ *
+ * One detector per node, one session per monitored point-to-point
+ * interface. Each session sends a small UDP probe to the peer address every
+ * Interval, bound to the link device so probes never follow a backup route.
+ * A session goes down when no probe has been received for
+ * Interval x Multiplier; it then withdraws from Ipv4StaticRouting every
+ * gateway route through its interface (the connected route stays, probes
+ * keep flowing). The first probe received afterwards brings the session
+ * back up and restores the withdrawn routes with their metrics.
+ *
+ * Withdrawal makes lookups fall through to the next best metric, e.g. the
+ * backup routes installed by BackupRoutingHelper (backup-routing.h).
+ */
+
+#ifndef LINK_LIVENESS_H
+#define LINK_LIVENESS_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class LinkLivenessDetector
+{
+  public:
+    // (node, interface, up) on every session state change
+    typedef std::function<void(Ptr<Node>, uint32_t, bool)> StateCallback;
+
+    static constexpr uint16_t PROBE_PORT = 3784; // BFD single-hop control port
+
+    LinkLivenessDetector(Ptr<Node> node, Time interval, uint32_t multiplier)
+        : m_node(node),
+          m_interval(interval),
+          m_multiplier(multiplier),
+          m_probesSent(0),
+          m_probesReceived(0)
+    {
+        Ipv4StaticRoutingHelper staticRoutingHelper;
+        m_routing = staticRoutingHelper.GetStaticRouting(node->GetObject<Ipv4>());
+    }
+
+    ~LinkLivenessDetector()
+    {
+        Stop();
+    }
+
+    void SetStateCallback(StateCallback callback)
+    {
+        m_stateCallback = callback;
+    }
+
+    // Monitor a point-to-point interface; the peer is found on its channel
+    void AddSession(uint32_t interface)
+    {
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+        Ptr<NetDevice> device = ipv4->GetNetDevice(interface);
+        Ptr<Channel> channel = device->GetChannel();
+        NS_ABORT_MSG_IF(!channel || channel->GetNDevices() != 2,
+                        "Liveness sessions need a point-to-point interface");
+
+        Ptr<NetDevice> peer = channel->GetDevice(channel->GetDevice(0) == device ? 1 : 0);
+        Ptr<Ipv4> peerIpv4 = peer->GetNode()->GetObject<Ipv4>();
+        int32_t peerInterface = peerIpv4->GetInterfaceForDevice(peer);
+        NS_ABORT_MSG_IF(peerInterface < 0, "Liveness peer has no IPv4 interface");
+
+        Session session;
+        session.interface = interface;
+        session.local = ipv4->GetAddress(interface, 0).GetLocal();
+        session.peer = peerIpv4->GetAddress(peerInterface, 0).GetLocal();
+        session.up = true;
+        session.socket = Socket::CreateSocket(m_node, UdpSocketFactory::GetTypeId());
+        session.socket->Bind(InetSocketAddress(session.local, PROBE_PORT));
+        session.socket->BindToNetDevice(device);
+        session.socket->Connect(InetSocketAddress(session.peer, PROBE_PORT));
+        session.socket->SetRecvCallback(
+            MakeCallback(&LinkLivenessDetector::ReceiveProbe, this));
+        m_sessionOf[PeekPointer(session.socket)] = m_sessions.size();
+        m_sessions.push_back(session);
+    }
+
+    // Monitor every point-to-point interface of the node
+    void AddAllSessions()
+    {
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+        for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+        {
+            Ptr<Channel> channel = ipv4->GetNetDevice(i)->GetChannel();
+            if (channel && channel->GetNDevices() == 2 && ipv4->GetNAddresses(i) > 0)
+            {
+                AddSession(i);
+            }
+        }
+    }
+
+    void Start(Time at)
+    {
+        for (uint32_t s = 0; s < m_sessions.size(); s++)
+        {
+            // Spread the first probes over one interval
+            Time offset = m_interval * (double(s) / m_sessions.size());
+            m_sessions[s].probe =
+                Simulator::Schedule(at + offset, &LinkLivenessDetector::SendProbe, this, s);
+            m_sessions[s].timeout = Simulator::Schedule(at + GetDetectionTime(),
+                                                        &LinkLivenessDetector::Expire,
+                                                        this,
+                                                        s);
+        }
+    }
+
+    void Stop()
+    {
+        for (Session& session : m_sessions)
+        {
+            session.probe.Cancel();
+            session.timeout.Cancel();
+            if (session.socket)
+            {
+                session.socket->Close();
+                session.socket = nullptr;
+            }
+        }
+    }
+
+    Time GetDetectionTime() const
+    {
+        return m_interval * m_multiplier;
+    }
+
+    bool IsUp(uint32_t interface) const
+    {
+        for (const Session& session : m_sessions)
+        {
+            if (session.interface == interface)
+            {
+                return session.up;
+            }
+        }
+        return false;
+    }
+
+    uint64_t GetProbesSent() const
+    {
+        return m_probesSent;
+    }
+
+    uint64_t GetProbesReceived() const
+    {
+        return m_probesReceived;
+    }
+
+  private:
+    struct WithdrawnRoute
+    {
+        Ipv4Address network;
+        Ipv4Mask mask;
+        Ipv4Address gateway;
+        uint32_t metric;
+    };
+
+    struct Session
+    {
+        uint32_t interface;
+        Ipv4Address local;
+        Ipv4Address peer;
+        bool up;
+        Ptr<Socket> socket;
+        EventId probe;
+        EventId timeout;
+        std::vector<WithdrawnRoute> withdrawn;
+    };
+
+    static constexpr uint32_t PROBE_SIZE = 24; // BFD control packet without auth
+
+    void SendProbe(uint32_t s)
+    {
+        m_sessions[s].socket->Send(Create<Packet>(PROBE_SIZE));
+        m_probesSent++;
+        m_sessions[s].probe =
+            Simulator::Schedule(m_interval, &LinkLivenessDetector::SendProbe, this, s);
+    }
+
+    void ReceiveProbe(Ptr<Socket> socket)
+    {
+        Ptr<Packet> packet;
+        while ((packet = socket->Recv()))
+        {
+            m_probesReceived++;
+        }
+        uint32_t s = m_sessionOf[PeekPointer(socket)];
+        Session& session = m_sessions[s];
+        session.timeout.Cancel();
+        session.timeout =
+            Simulator::Schedule(GetDetectionTime(), &LinkLivenessDetector::Expire, this, s);
+        if (!session.up)
+        {
+            session.up = true;
+            RestoreRoutes(session);
+            NotifyState(session);
+        }
+    }
+
+    void Expire(uint32_t s)
+    {
+        Session& session = m_sessions[s];
+        if (!session.up)
+        {
+            return;
+        }
+        session.up = false;
+        WithdrawRoutes(session);
+        NotifyState(session);
+    }
+
+    void WithdrawRoutes(Session& session)
+    {
+        // Backwards so that indices stay valid while removing
+        for (uint32_t i = m_routing->GetNRoutes(); i-- > 0;)
+        {
+            Ipv4RoutingTableEntry route = m_routing->GetRoute(i);
+            if (route.GetInterface() != session.interface ||
+                route.GetGateway() == Ipv4Address::GetZero())
+            {
+                continue;
+            }
+            session.withdrawn.push_back({route.GetDestNetwork(),
+                                         route.GetDestNetworkMask(),
+                                         route.GetGateway(),
+                                         m_routing->GetMetric(i)});
+            m_routing->RemoveRoute(i);
+        }
+    }
+
+    void RestoreRoutes(Session& session)
+    {
+        for (const WithdrawnRoute& route : session.withdrawn)
+        {
+            m_routing->AddNetworkRouteTo(route.network,
+                                         route.mask,
+                                         route.gateway,
+                                         session.interface,
+                                         route.metric);
+        }
+        session.withdrawn.clear();
+    }
+
+    void NotifyState(const Session& session)
+    {
+        if (m_stateCallback)
+        {
+            m_stateCallback(m_node, session.interface, session.up);
+        }
+    }
+
+    Ptr<Node> m_node;
+    Ptr<Ipv4StaticRouting> m_routing;
+    Time m_interval;
+    uint32_t m_multiplier;
+    std::vector<Session> m_sessions;
+    std::unordered_map<Socket*, uint32_t> m_sessionOf;
+    StateCallback m_stateCallback;
+    uint64_t m_probesSent;
+    uint64_t m_probesReceived;
+};
+
+} // namespace ns3
+
+#endif // LINK_LIVENESS_H
@@ -0,0 +1,256 @@
+/*
+ * Export asynchrone de séries temporelles (métriques QoS par classe et
+ * métriques de chemin par interface).
+ *
+ * Le thread du simulateur ajoute des enregistrements à taille fixe dans un
+ * tampon mémoire ; un thread d'écriture vide le tampon précédent sur disque
+ * (double tampon). Aucun formatage ni appel d'E/S n'a lieu sur la boucle
+ * d'évènements : si l'écrivain n'a pas fini, le tampon courant grandit au
+ * lieu de bloquer la simulation.
+ *
+ * Formats de fichier (EXPORT_ROWS et EXPORT_COLUMNS commencent par un
+ * en-tête de 16 octets : "MTRX", version, format, taille d'enregistrement) :
+ *   EXPORT_ROWS    : enregistrements MetricsRecord bruts, l'un après l'autre
+ *   EXPORT_COLUMNS : blocs { uint64 n ; timeNs[n] ; series[n] ; id[n] ;
+ *                    values[0][n] ... values[5][n] } (disposition colonnaire)
+ *   EXPORT_CSV     : texte, une ligne par enregistrement
+ */
+
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum MetricsSeries {
+    SERIES_CLASS = 1,       // values: tx, rx, perte %, délai ms, gigue ms, débit Mbps
+    SERIES_PATH = 2         // values: latence ms, EWMA ms, P99 ms, débit Mbps, envoyés, reçus
+};
+
+enum ExportFormat {
+    EXPORT_ROWS,
+    EXPORT_COLUMNS,
+    EXPORT_CSV
+};
+
+// Enregistrement binaire à taille fixe (64 octets, une ligne de cache)
+struct MetricsRecord {
+    static const uint32_t NUM_VALUES = 6;
+
+    int64_t timeNs;
+    uint32_t series;        // MetricsSeries
+    uint32_t id;            // Classe de trafic ou interface
+    double values[NUM_VALUES];
+};
+
+inline bool ParseExportFormat(const std::string& name, ExportFormat& format) {
+    if (name == "rows") {
+        format = EXPORT_ROWS;
+    } else if (name == "columns") {
+        format = EXPORT_COLUMNS;
+    } else if (name == "csv") {
+        format = EXPORT_CSV;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+class MetricsExporter {
+private:
+    static const uint32_t FILE_VERSION = 1;
+
+    std::ofstream m_file;
+    ExportFormat m_format;
+    uint32_t m_capacity;            // Enregistrements par tampon
+    size_t m_flushThreshold;        // Taille déclenchant la remise à l'écrivain
+
+    std::vector<MetricsRecord> m_front;     // Rempli par le simulateur
+    std::vector<MetricsRecord> m_back;      // Vidé par l'écrivain
+    std::string m_text;                     // Tampon de formatage (écrivain)
+    std::vector<char> m_column;             // Tampon colonnaire (écrivain)
+
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_running;
+    bool m_pending;                 // m_back contient un bloc à écrire
+    uint64_t m_overruns;            // Remises différées (écrivain occupé)
+    uint64_t m_recordsWritten;
+
+public:
+    MetricsExporter()
+        : m_format(EXPORT_ROWS),
+          m_capacity(0),
+          m_flushThreshold(0),
+          m_running(false),
+          m_pending(false),
+          m_overruns(0),
+          m_recordsWritten(0) {}
+
+    ~MetricsExporter() {
+        Close();
+    }
+
+    bool Open(const std::string& filename, ExportFormat format = EXPORT_ROWS,
+              uint32_t bufferRecords = 8192) {
+        if (m_running) return false;
+
+        m_file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!m_file) return false;
+
+        m_format = format;
+        m_capacity = bufferRecords > 0 ? bufferRecords : 1;
+        m_flushThreshold = m_capacity;
+        m_front.reserve(m_capacity);
+        m_back.reserve(m_capacity);
+        WriteFileHeader();
+
+        m_running = true;
+        m_writer = std::thread(&MetricsExporter::WriterLoop, this);
+        return true;
+    }
+
+    bool IsOpen() const {
+        return m_running;
+    }
+
+    // Appelé depuis le thread du simulateur : copie en mémoire uniquement
+    void Append(const MetricsRecord& record) {
+        m_front.push_back(record);
+        if (m_front.size() >= m_flushThreshold) {
+            Flush();
+        }
+    }
+
+    // Remet le tampon courant à l'écrivain s'il est libre, sans jamais attendre
+    void Flush() {
+        if (!m_running || m_front.empty()) return;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_pending) {
+            m_overruns++;
+            m_flushThreshold = m_front.size() + m_capacity;
+            return;
+        }
+        m_front.swap(m_back);
+        m_pending = true;
+        lock.unlock();
+        m_cv.notify_all();
+
+        m_flushThreshold = m_capacity;
+    }
+
+    // Fin de simulation : attend l'écriture de tous les enregistrements
+    void Close() {
+        if (!m_running) return;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return !m_pending; });
+        m_front.swap(m_back);
+        m_pending = !m_back.empty();
+        m_running = false;
+        lock.unlock();
+        m_cv.notify_all();
+
+        m_writer.join();
+        m_file.close();
+    }
+
+    uint64_t GetOverruns() const {
+        return m_overruns;
+    }
+
+    uint64_t GetRecordsWritten() const {
+        return m_recordsWritten;
+    }
+
+private:
+    void WriteFileHeader() {
+        if (m_format == EXPORT_CSV) {
+            m_file << "time_ns,series,id,v0,v1,v2,v3,v4,v5\n";
+            return;
+        }
+        uint32_t header[4] = {0x5854524d, FILE_VERSION, uint32_t(m_format),
+                              uint32_t(sizeof(MetricsRecord))};   // "MTRX"
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    void WriterLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this] { return m_pending || !m_running; });
+            if (!m_pending) break;
+
+            lock.unlock();
+            WriteBlock(m_back);
+            m_recordsWritten += m_back.size();
+            m_back.clear();
+            lock.lock();
+
+            m_pending = false;
+            m_cv.notify_all();
+        }
+        m_file.flush();
+    }
+
+    void WriteBlock(const std::vector<MetricsRecord>& records) {
+        switch (m_format) {
+            case EXPORT_ROWS:
+                m_file.write(reinterpret_cast<const char*>(records.data()),
+                             records.size() * sizeof(MetricsRecord));
+                break;
+            case EXPORT_COLUMNS:
+                WriteColumns(records);
+                break;
+            case EXPORT_CSV:
+                WriteCsv(records);
+                break;
+        }
+    }
+
+    template <typename T, typename Getter>
+    void AppendColumn(const std::vector<MetricsRecord>& records, Getter get) {
+        size_t offset = m_column.size();
+        m_column.resize(offset + records.size() * sizeof(T));
+        T* out = reinterpret_cast<T*>(m_column.data() + offset);
+        for (size_t i = 0; i < records.size(); i++) {
+            out[i] = get(records[i]);
+        }
+    }
+
+    void WriteColumns(const std::vector<MetricsRecord>& records) {
+        uint64_t count = records.size();   // 8 octets : colonnes alignées
+        m_column.resize(sizeof(count));
+        std::memcpy(m_column.data(), &count, sizeof(count));
+        AppendColumn<int64_t>(records, [](const MetricsRecord& r) { return r.timeNs; });
+        AppendColumn<uint32_t>(records, [](const MetricsRecord& r) { return r.series; });
+        AppendColumn<uint32_t>(records, [](const MetricsRecord& r) { return r.id; });
+        for (uint32_t k = 0; k < MetricsRecord::NUM_VALUES; k++) {
+            AppendColumn<double>(records, [k](const MetricsRecord& r) { return r.values[k]; });
+        }
+        m_file.write(m_column.data(), m_column.size());
+    }
+
+    void WriteCsv(const std::vector<MetricsRecord>& records) {
+        m_text.clear();
+        char line[256];
+        for (const MetricsRecord& r : records) {
+            int n = snprintf(line, sizeof(line), "%lld,%u,%u,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n",
+                             static_cast<long long>(r.timeNs), r.series, r.id,
+                             r.values[0], r.values[1], r.values[2],
+                             r.values[3], r.values[4], r.values[5]);
+            m_text.append(line, n);
+        }
+        m_file.write(m_text.data(), m_text.size());
+    }
+};
+
+#endif // METRICS_EXPORTER_H
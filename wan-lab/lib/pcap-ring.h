@@ -0,0 +1,269 @@
+/*
+ * Triggered PCAP capture from per-device in-memory rings
+ *
+ * Instead of writing every packet of the run, each point-to-point device
+ * keeps its recent packets in memory (the last Window, at most MaxBytes).
+ * Trigger() dumps the rings to one pcap file per device, then keeps
+ * writing live for PostTrigger before returning to ring mode, so that a
+ * capture frames the event: prefix-<trigger>-<node>-<device>.pcap.
+ *
+ * Stored packets are copy-on-write copies: the ring costs one reference
+ * per packet, no payload copy.
+ *
+ * Sampling 1 in K is flow-consistent: the decision hashes the IPv4 5-tuple,
+ * so a sampled flow is captured whole, in both directions. Non-IPv4 frames
+ * are always kept.
+ *
+ * Triggers are logged at LOG_INFO by the "PcapRingCapture" log component.
+ */
+
+#ifndef PCAP_RING_H
+#define PCAP_RING_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class PcapRingCapture
+{
+  public:
+    explicit PcapRingCapture(const std::string& prefix)
+        : m_prefix(prefix),
+          m_window(Seconds(2.0)),
+          m_maxBytes(4 * 1024 * 1024),
+          m_postTrigger(Seconds(1.0)),
+          m_sampling(1),
+          m_triggers(0),
+          m_packetsSeen(0),
+          m_packetsSampledOut(0),
+          m_packetsWritten(0)
+    {
+    }
+
+    ~PcapRingCapture()
+    {
+        m_closeEvent.Cancel();
+        CloseFiles();
+    }
+
+    // Ring depth per device: whichever of the two limits is reached first
+    void SetWindow(Time window, uint32_t maxBytes)
+    {
+        m_window = window;
+        m_maxBytes = maxBytes;
+    }
+
+    void SetPostTrigger(Time postTrigger)
+    {
+        m_postTrigger = postTrigger;
+    }
+
+    // Keep 1 flow in k (1 = every packet)
+    void SetSampling(uint32_t k)
+    {
+        m_sampling = std::max<uint32_t>(k, 1);
+    }
+
+    void Install(Ptr<NetDevice> device)
+    {
+        NS_ABORT_MSG_IF(!DynamicCast<PointToPointNetDevice>(device),
+                        "PcapRingCapture supports point-to-point devices only");
+        m_rings.emplace_back(new DeviceRing());
+        DeviceRing* ring = m_rings.back().get();
+        ring->owner = this;
+        ring->device = device;
+        ring->bytes = 0;
+        device->TraceConnectWithoutContext("PromiscSniffer",
+                                           MakeBoundCallback(&PcapRingCapture::Sniff, ring));
+    }
+
+    void Install(const NetDeviceContainer& devices)
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Install(devices.Get(i));
+        }
+    }
+
+    // Dump the rings and capture live for PostTrigger; a trigger during a
+    // live capture extends it into the same files
+    void Trigger(const std::string& reason)
+    {
+        Time now = Simulator::Now();
+        NS_LOG_INFO("trigger " << m_triggers << " at " << now.As(Time::S) << ": " << reason);
+
+        if (now < m_liveUntil)
+        {
+            m_liveUntil = now + m_postTrigger;
+            return;
+        }
+
+        for (const std::unique_ptr<DeviceRing>& ring : m_rings)
+        {
+            std::ostringstream filename;
+            filename << m_prefix << "-" << m_triggers << "-" << ring->device->GetNode()->GetId()
+                     << "-" << ring->device->GetIfIndex() << ".pcap";
+            PcapHelper pcapHelper;
+            ring->file = pcapHelper.CreateFile(filename.str(), std::ios::out, PcapHelper::DLT_PPP);
+            for (const Entry& entry : ring->packets)
+            {
+                ring->file->Write(entry.time, entry.packet);
+                m_packetsWritten++;
+            }
+            ring->packets.clear();
+            ring->bytes = 0;
+        }
+        m_triggers++;
+        m_liveUntil = now + m_postTrigger;
+        m_closeEvent = Simulator::Schedule(m_postTrigger, &PcapRingCapture::EndLive, this);
+    }
+
+    uint32_t GetTriggers() const
+    {
+        return m_triggers;
+    }
+
+    uint64_t GetPacketsSeen() const
+    {
+        return m_packetsSeen;
+    }
+
+    uint64_t GetPacketsSampledOut() const
+    {
+        return m_packetsSampledOut;
+    }
+
+    uint64_t GetPacketsWritten() const
+    {
+        return m_packetsWritten;
+    }
+
+  private:
+    // Header-only: the NS_LOG_* macros of the member functions find this
+    // component, one instance for every program including the file
+    static inline LogComponent g_log{"PcapRingCapture", __FILE__};
+
+    struct Entry
+    {
+        Time time;
+        Ptr<const Packet> packet;
+    };
+
+    struct DeviceRing
+    {
+        PcapRingCapture* owner;
+        Ptr<NetDevice> device;
+        std::deque<Entry> packets;
+        uint64_t bytes;
+        Ptr<PcapFileWrapper> file; // Open during a live capture
+    };
+
+    static void Sniff(DeviceRing* ring, Ptr<const Packet> packet)
+    {
+        ring->owner->Capture(*ring, packet);
+    }
+
+    void Capture(DeviceRing& ring, Ptr<const Packet> packet)
+    {
+        m_packetsSeen++;
+        if (m_sampling > 1 && FlowHash(packet) % m_sampling != 0)
+        {
+            m_packetsSampledOut++;
+            return;
+        }
+
+        Time now = Simulator::Now();
+        if (ring.file)
+        {
+            ring.file->Write(now, packet);
+            m_packetsWritten++;
+            return;
+        }
+
+        ring.packets.push_back(Entry{now, packet->Copy()});
+        ring.bytes += packet->GetSize();
+        while (!ring.packets.empty() &&
+               (ring.bytes > m_maxBytes || ring.packets.front().time < now - m_window))
+        {
+            ring.bytes -= ring.packets.front().packet->GetSize();
+            ring.packets.pop_front();
+        }
+    }
+
+    // Symmetric in the endpoints so that both directions of a flow agree
+    static uint32_t FlowHash(Ptr<const Packet> packet)
+    {
+        PppHeader ppp;
+        Ipv4Header ip;
+        Ptr<Packet> copy = packet->Copy();
+        copy->RemoveHeader(ppp);
+        if (ppp.GetProtocol() != 0x0021) // IPv4
+        {
+            return 0;
+        }
+        copy->RemoveHeader(ip);
+
+        uint32_t ports = 0;
+        uint8_t buffer[4];
+        if ((ip.GetProtocol() == 6 || ip.GetProtocol() == 17) &&
+            copy->CopyData(buffer, sizeof(buffer)) == sizeof(buffer))
+        {
+            uint16_t src = (buffer[0] << 8) | buffer[1];
+            uint16_t dst = (buffer[2] << 8) | buffer[3];
+            ports = uint32_t(src) ^ uint32_t(dst);
+        }
+
+        uint32_t key[3] = {ip.GetSource().Get() ^ ip.GetDestination().Get(),
+                           ports,
+                           ip.GetProtocol()};
+        return Hash32(reinterpret_cast<const char*>(key), sizeof(key));
+    }
+
+    void EndLive()
+    {
+        if (Simulator::Now() < m_liveUntil)
+        {
+            m_closeEvent = Simulator::Schedule(m_liveUntil - Simulator::Now(),
+                                               &PcapRingCapture::EndLive,
+                                               this);
+            return;
+        }
+        CloseFiles();
+    }
+
+    void CloseFiles()
+    {
+        for (const std::unique_ptr<DeviceRing>& ring : m_rings)
+        {
+            ring->file = nullptr;
+        }
+    }
+
+    std::string m_prefix;
+    Time m_window;
+    uint32_t m_maxBytes;
+    Time m_postTrigger;
+    uint32_t m_sampling;
+    std::vector<std::unique_ptr<DeviceRing>> m_rings;
+    Time m_liveUntil;
+    EventId m_closeEvent;
+    uint32_t m_triggers;
+    uint64_t m_packetsSeen;
+    uint64_t m_packetsSampledOut;
+    uint64_t m_packetsWritten;
+};
+
+} // namespace ns3
+
+#endif // PCAP_RING_H
@@ -0,0 +1,251 @@
+/*
+ * Compteurs et chronomètres des chemins chauds des composants du scénario.
+ *
+ * PERF_SCOPE("nom") chronomètre le bloc englobant (temps inclusif : un
+ * callback appelé depuis un autre bloc mesuré compte dans les deux) ;
+ * PERF_COUNT("nom", n) ajoute n à un compteur sans chronométrage. Chaque
+ * site d'appel résout son PerfProbe une seule fois (variable statique
+ * locale), puis ne coûte qu'une lecture d'horloge à l'entrée et à la sortie
+ * plus un histogramme log2 en ticks, sans allocation ni formatage.
+ *
+ * Horloge : TSC (rdtsc) sur x86, steady_clock ailleurs. Les ticks sont
+ * convertis en ns au moment du rapport, d'après le rapport TSC/steady_clock
+ * mesuré depuis la création du registre.
+ *
+ * -DPERF_COUNTERS=0 supprime entièrement l'instrumentation : les macros ne
+ * produisent plus de code et le registre reste vide.
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS 1
+#endif
+
+inline uint64_t PerfTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Statistiques d'un site mesuré, en ticks
+struct PerfProbe {
+    static const uint32_t NUM_BUCKETS = 48;     // Intervalles [2^k, 2^(k+1)) ticks
+
+    std::string name;
+    bool timed;
+    uint64_t calls;
+    uint64_t totalTicks;
+    uint64_t maxTicks;
+    uint64_t histogram[NUM_BUCKETS];
+
+    void Record(uint64_t ticks) {
+        calls++;
+        totalTicks += ticks;
+        if (ticks > maxTicks) maxTicks = ticks;
+        uint32_t bucket = ticks == 0 ? 0 : 63 - __builtin_clzll(ticks);
+        histogram[bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1]++;
+    }
+
+    // Borne supérieure du seuil quantile (ticks, à un facteur 2 près)
+    uint64_t QuantileTicks(double q) const {
+        uint64_t target = uint64_t(q * calls);
+        uint64_t seen = 0;
+        for (uint32_t b = 0; b < NUM_BUCKETS; b++) {
+            seen += histogram[b];
+            if (seen > target) return std::min<uint64_t>(uint64_t(2) << b, maxTicks);
+        }
+        return maxTicks;
+    }
+};
+
+// Photographie d'un site, convertie en ns
+struct PerfStats {
+    std::string name;
+    bool timed;
+    uint64_t calls;
+    double totalNs;
+    double meanNs;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+};
+
+class PerfRegistry {
+private:
+    std::deque<PerfProbe> m_probes;     // Adresses stables pour les sites d'appel
+    uint64_t m_startTicks;
+    std::chrono::steady_clock::time_point m_startClock;
+    ns3::EventId m_snapshotEvent;
+
+public:
+    PerfRegistry()
+        : m_startTicks(PerfTicks()),
+          m_startClock(std::chrono::steady_clock::now()) {}
+
+    static PerfRegistry& Get() {
+        static PerfRegistry registry;
+        return registry;
+    }
+
+    PerfProbe* Register(const std::string& name, bool timed = true) {
+        for (PerfProbe& probe : m_probes) {
+            if (probe.name == name) return &probe;
+        }
+        m_probes.push_back(PerfProbe());
+        PerfProbe& probe = m_probes.back();
+        probe.name = name;
+        probe.timed = timed;
+        probe.calls = 0;
+        probe.totalTicks = 0;
+        probe.maxTicks = 0;
+        std::fill(probe.histogram, probe.histogram + PerfProbe::NUM_BUCKETS, 0);
+        return &probe;
+    }
+
+    // Ns par tick d'après le temps écoulé depuis la création du registre
+    double NsPerTick() const {
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - m_startClock).count();
+        uint64_t ticks = PerfTicks() - m_startTicks;
+        return ticks > 0 && ns > 0 ? ns / ticks : 1.0;
+    }
+
+    double ElapsedNs() const {
+        return std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - m_startClock).count();
+    }
+
+    std::vector<PerfStats> Snapshot() const {
+        double scale = NsPerTick();
+        std::vector<PerfStats> stats;
+        for (const PerfProbe& probe : m_probes) {
+            PerfStats s;
+            s.name = probe.name;
+            s.timed = probe.timed;
+            s.calls = probe.calls;
+            s.totalNs = probe.totalTicks * scale;
+            s.meanNs = probe.calls > 0 ? s.totalNs / probe.calls : 0.0;
+            s.p50Ns = probe.QuantileTicks(0.50) * scale;
+            s.p99Ns = probe.QuantileTicks(0.99) * scale;
+            s.maxNs = probe.maxTicks * scale;
+            stats.push_back(s);
+        }
+        return stats;
+    }
+
+    void Reset() {
+        for (PerfProbe& probe : m_probes) {
+            probe.calls = 0;
+            probe.totalTicks = 0;
+            probe.maxTicks = 0;
+            std::fill(probe.histogram, probe.histogram + PerfProbe::NUM_BUCKETS, 0);
+        }
+    }
+
+    void Report(std::ostream& os) const {
+        std::vector<PerfStats> stats = Snapshot();
+        double elapsedNs = ElapsedNs();
+        char line[160];
+        os << "\n========== INSTRUMENTATION ==========\n";
+        snprintf(line, sizeof(line), "%-34s %10s %10s %9s %9s %9s %7s\n", "site", "appels",
+                 "total ms", "moy. ns", "P99 ns", "max ns", "% mur");
+        os << line;
+        for (const PerfStats& s : stats) {
+            if (!s.timed) {
+                snprintf(line, sizeof(line), "%-34s %10llu\n", s.name.c_str(),
+                         static_cast<unsigned long long>(s.calls));
+            } else {
+                snprintf(line, sizeof(line), "%-34s %10llu %10.3f %9.0f %9.0f %9.0f %6.2f%%\n",
+                         s.name.c_str(), static_cast<unsigned long long>(s.calls),
+                         s.totalNs / 1e6, s.meanNs, s.p99Ns, s.maxNs,
+                         elapsedNs > 0 ? 100.0 * s.totalNs / elapsedNs : 0.0);
+            }
+            os << line;
+        }
+        snprintf(line, sizeof(line), "Temps mur depuis le démarrage: %.3f ms "
+                 "(le reste est le noyau ns-3 et les modules non instrumentés)\n",
+                 elapsedNs / 1e6);
+        os << line;
+        os << "=====================================\n";
+    }
+
+    // Rapport sur std::cout au moment de Simulator::Destroy()
+    void ReportAtDestroy() {
+        ns3::Simulator::ScheduleDestroy(&PerfRegistry::ReportToStdout);
+    }
+
+    // Photographie périodique remise à l'appelant (temps de simulation)
+    void StartSnapshots(ns3::Time interval,
+                        std::function<void(const std::vector<PerfStats>&)> callback) {
+        m_snapshotEvent.Cancel();
+        m_snapshotEvent = ns3::Simulator::Schedule(interval, &PerfRegistry::TakeSnapshot,
+                                                   this, interval, callback);
+    }
+
+private:
+    static void ReportToStdout() {
+        Get().Report(std::cout);
+    }
+
+    void TakeSnapshot(ns3::Time interval,
+                      std::function<void(const std::vector<PerfStats>&)> callback) {
+        callback(Snapshot());
+        m_snapshotEvent = ns3::Simulator::Schedule(interval, &PerfRegistry::TakeSnapshot,
+                                                   this, interval, callback);
+    }
+};
+
+// Chronomètre RAII : mesure jusqu'à la sortie du bloc, retours anticipés compris
+class PerfScope {
+private:
+    PerfProbe* m_probe;
+    uint64_t m_start;
+
+public:
+    explicit PerfScope(PerfProbe* probe) : m_probe(probe), m_start(PerfTicks()) {}
+
+    ~PerfScope() {
+        m_probe->Record(PerfTicks() - m_start);
+    }
+};
+
+#define PERF_CONCAT_(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_(a, b)
+
+#if PERF_COUNTERS
+#define PERF_SCOPE(name)                                                                   \
+    static PerfProbe* PERF_CONCAT(perfProbe_, __LINE__) = PerfRegistry::Get().Register(name); \
+    PerfScope PERF_CONCAT(perfScope_, __LINE__)(PERF_CONCAT(perfProbe_, __LINE__))
+
+#define PERF_COUNT(name, n)                                                                \
+    do {                                                                                   \
+        static PerfProbe* perfProbe_ = PerfRegistry::Get().Register(name, false);          \
+        perfProbe_->calls += (n);                                                          \
+    } while (0)
+#else
+#define PERF_SCOPE(name) do {} while (0)
+#define PERF_COUNT(name, n) do {} while (0)
+#endif
+
+#endif // PERF_COUNTERS_H
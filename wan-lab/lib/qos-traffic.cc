@@ -0,0 +1,894 @@
+/*
+ * Générateurs de trafic et collecteur QoS de l'exercice 2 (voir qos-traffic.h)
+ */
+
+#include "qos-traffic.h"
+
+#include "event-log.h"
+#include "perf-counters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("QosTraffic");
+
+// ========== QUESTION 1: GÉNÉRATEURS DE TRAFIC AVEC MARQUAGE DSCP ==========
+
+uint32_t CodecPayloadSize(VoipCodec codec) {
+    switch (codec) {
+        case CODEC_G729: return 20;
+        case CODEC_OPUS: return 80;
+        default: return 160;
+    }
+}
+
+TypeId VoipTrafficGenerator::GetTypeId(void) {
+    static TypeId tid = TypeId("VoipTrafficGenerator")
+        .SetParent<Application>()
+        .SetGroupName("Applications")
+        .AddConstructor<VoipTrafficGenerator>()
+        .AddAttribute("Codec",
+                      "Codec voix (taille de la charge utile par trame de 20 ms)",
+                      EnumValue(CODEC_G711),
+                      MakeEnumAccessor<VoipCodec>(&VoipTrafficGenerator::m_codec),
+                      MakeEnumChecker(CODEC_G711, "G711",
+                                      CODEC_G729, "G729",
+                                      CODEC_OPUS, "Opus"));
+    return tid;
+}
+
+VoipTrafficGenerator::VoipTrafficGenerator()
+    : m_socket(0),
+      m_codec(CODEC_G711),
+      m_packetSize(160),        // G.711: 64 kbps = 160 bytes @ 50pps
+      m_interval(MilliSeconds(20)),
+      m_packetsSent(0),
+      m_dscp(46) {              // EF (Expedited Forwarding) DSCP 46
+}
+
+VoipTrafficGenerator::~VoipTrafficGenerator() {
+    m_socket = 0;
+}
+
+void VoipTrafficGenerator::DoDispose(void) {
+    Application::DoDispose();
+}
+
+void VoipTrafficGenerator::Setup(Ipv4Address destAddr, uint16_t destPort) {
+    m_destAddr = destAddr;
+    m_destPort = destPort;
+}
+
+void VoipTrafficGenerator::StartApplication(void) {
+    if (!m_socket) {
+        TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+        m_socket = Socket::CreateSocket(GetNode(), tid);
+        
+        InetSocketAddress remote = InetSocketAddress(m_destAddr, m_destPort);
+        m_socket->Connect(remote);
+        
+        // Marquage DSCP EF (46) -> TOS = 0xB8 (46 << 2)
+        m_socket->SetIpTos(0xB8);
+        NS_LOG_INFO("VoIP: DSCP marqué à EF (46), TOS=0xB8");
+    }
+    
+    m_packetSize = CodecPayloadSize(m_codec);
+    
+    SendPacket();
+}
+
+void VoipTrafficGenerator::StopApplication(void) {
+    if (m_sendEvent.IsPending()) {
+        Simulator::Cancel(m_sendEvent);
+    }
+    if (m_socket) {
+        m_socket->Close();
+    }
+}
+
+void VoipTrafficGenerator::SendPacket(void) {
+    PERF_SCOPE("VoipTrafficGenerator::SendPacket");
+    // Un paquet neuf par trame : chaque envoi a son propre uid (FlowMonitor,
+    // PathMetricsMonitor et la trace d'animation identifient les paquets par
+    // uid). La charge utile est une zone nulle : aucun octet n'est alloué.
+    Ptr<Packet> packet = Create<Packet>(m_packetSize);
+    m_socket->Send(packet);
+    m_packetsSent++;
+    
+    EVENT_LOG(EVLOG_VOIP, EVT_VOIP_SEND, GetNode()->GetId(), m_packetsSent, packet->GetSize());
+    
+    m_sendEvent = Simulator::Schedule(m_interval, 
+                                      &VoipTrafficGenerator::SendPacket, this);
+}
+
+TypeId VoipCallTag::GetTypeId(void) {
+    static TypeId tid = TypeId("VoipCallTag")
+        .SetParent<Tag>()
+        .SetGroupName("Applications")
+        .AddConstructor<VoipCallTag>();
+    return tid;
+}
+
+TypeId VoipCallTag::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+uint32_t VoipCallTag::GetSerializedSize(void) const {
+    return 4;
+}
+
+void VoipCallTag::Serialize(TagBuffer i) const {
+    i.WriteU32(m_callId);
+}
+
+void VoipCallTag::Deserialize(TagBuffer i) {
+    m_callId = i.ReadU32();
+}
+
+void VoipCallTag::Print(std::ostream& os) const {
+    os << "call=" << m_callId;
+}
+
+VoipCallTag::VoipCallTag()
+    : m_callId(0) {
+}
+
+VoipCallTag::VoipCallTag(uint32_t callId)
+    : m_callId(callId) {
+}
+
+uint32_t VoipCallTag::GetCallId(void) const {
+    return m_callId;
+}
+
+TypeId VoipCallGroup::GetTypeId(void) {
+    static TypeId tid = TypeId("VoipCallGroup")
+        .SetParent<Application>()
+        .SetGroupName("Applications")
+        .AddConstructor<VoipCallGroup>()
+        .AddAttribute("NumCalls",
+                      "Nombre d'appels logiques multiplexés",
+                      UintegerValue(100),
+                      MakeUintegerAccessor(&VoipCallGroup::m_numCalls),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("Codec",
+                      "Codec voix (taille de la charge utile par trame)",
+                      EnumValue(CODEC_G711),
+                      MakeEnumAccessor<VoipCodec>(&VoipCallGroup::m_codec),
+                      MakeEnumChecker(CODEC_G711, "G711",
+                                      CODEC_G729, "G729",
+                                      CODEC_OPUS, "Opus"))
+        .AddAttribute("Interval",
+                      "Intervalle entre deux trames d'un même appel",
+                      TimeValue(MilliSeconds(20)),
+                      MakeTimeAccessor(&VoipCallGroup::m_interval),
+                      MakeTimeChecker(NanoSeconds(1)))
+        .AddAttribute("TickResolution",
+                      "Durée d'une case de la roue temporelle",
+                      TimeValue(MilliSeconds(1)),
+                      MakeTimeAccessor(&VoipCallGroup::m_tick),
+                      MakeTimeChecker(NanoSeconds(1)))
+        .AddAttribute("WheelSlots",
+                      "Nombre de cases de la roue temporelle",
+                      UintegerValue(64),
+                      MakeUintegerAccessor(&VoipCallGroup::m_wheelSlots),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("StartJitter",
+                      "Dispersion uniforme du début des appels",
+                      TimeValue(Seconds(1.0)),
+                      MakeTimeAccessor(&VoipCallGroup::m_startJitter),
+                      MakeTimeChecker())
+        .AddAttribute("CallDuration",
+                      "Durée d'un appel (0 = jusqu'à l'arrêt du groupe)",
+                      TimeValue(Seconds(0)),
+                      MakeTimeAccessor(&VoipCallGroup::m_callDuration),
+                      MakeTimeChecker())
+        .AddAttribute("StopJitter",
+                      "Raccourcissement uniforme de la durée de chaque appel",
+                      TimeValue(Seconds(0)),
+                      MakeTimeAccessor(&VoipCallGroup::m_stopJitter),
+                      MakeTimeChecker());
+    return tid;
+}
+
+VoipCallGroup::VoipCallGroup()
+    : m_currentSlot(0),
+      m_tickSteps(1),
+      m_armedCalls(0),
+      m_periodTicks(1),
+      m_payloadSize(160),
+      m_numCalls(100),
+      m_codec(CODEC_G711),
+      m_interval(MilliSeconds(20)),
+      m_tick(MilliSeconds(1)),
+      m_wheelSlots(64),
+      m_startJitter(Seconds(1.0)),
+      m_callDuration(Seconds(0)),
+      m_stopJitter(Seconds(0)),
+      m_packetsSent(0) {
+    m_jitter = CreateObject<UniformRandomVariable>();
+}
+
+VoipCallGroup::~VoipCallGroup() {
+}
+
+void VoipCallGroup::DoDispose(void) {
+    m_sockets.clear();
+    m_wheel.clear();
+    m_jitter = 0;
+    Application::DoDispose();
+}
+
+void VoipCallGroup::AddDestination(Ipv4Address destAddr, uint16_t destPort) {
+    m_destAddrs.push_back(destAddr);
+    m_destPorts.push_back(destPort);
+}
+
+uint32_t VoipCallGroup::GetActiveCalls(void) const {
+    return m_armedCalls;
+}
+
+uint64_t VoipCallGroup::GetPacketsSent(void) const {
+    return m_packetsSent;
+}
+
+void VoipCallGroup::StartApplication(void) {
+    NS_ABORT_MSG_IF(m_destAddrs.empty(), "VoipCallGroup: aucune destination");
+    // La roue avance par cases entières : une période qui ne tombe pas sur une
+    // case dériverait à chaque réarmement.
+    NS_ABORT_MSG_IF(m_tick > m_interval || !(m_interval % m_tick).IsZero(),
+                    "VoipCallGroup: TickResolution (" << m_tick
+                    << ") doit diviser Interval (" << m_interval << ")");
+    
+    if (m_sockets.empty()) {
+        TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+        for (uint32_t d = 0; d < m_destAddrs.size(); d++) {
+            Ptr<Socket> socket = Socket::CreateSocket(GetNode(), tid);
+            socket->Connect(InetSocketAddress(m_destAddrs[d], m_destPorts[d]));
+            socket->SetIpTos(0xB8);     // DSCP EF (46)
+            m_sockets.push_back(socket);
+        }
+    }
+    
+    m_payloadSize = CodecPayloadSize(m_codec);
+    m_wheel.assign(m_wheelSlots, std::vector<WheelEntry>());
+    m_currentSlot = 0;
+    m_armedCalls = 0;
+    m_periodTicks = m_interval.GetTimeStep() / m_tick.GetTimeStep();
+    
+    // Chaque appel démarre à un instant aléatoire de [0, StartJitter]
+    Time now = Simulator::Now();
+    m_calls.assign(m_numCalls, Call());
+    for (uint32_t i = 0; i < m_numCalls; i++) {
+        Time startDelay = Seconds(m_jitter->GetValue(0.0, m_startJitter.GetSeconds()));
+        Call& call = m_calls[i];
+        call.destination = i % m_sockets.size();
+        call.packetsSent = 0;
+        call.stopTime = Time::Max();
+        if (m_callDuration.IsStrictlyPositive()) {
+            Time shortening = Seconds(m_jitter->GetValue(0.0, m_stopJitter.GetSeconds()));
+            call.stopTime = now + startDelay + m_callDuration - shortening;
+        }
+        Arm(i, startDelay.GetTimeStep() / m_tick.GetTimeStep() + 1);
+    }
+    
+    NS_LOG_INFO("VoipCallGroup: " << m_numCalls << " appels sur " << m_sockets.size()
+                << " socket(s), roue de " << m_wheelSlots << " cases");
+    ScheduleTick();
+}
+
+void VoipCallGroup::StopApplication(void) {
+    Simulator::Cancel(m_tickEvent);
+    for (Ptr<Socket> socket : m_sockets) {
+        socket->Close();
+    }
+    m_wheel.clear();
+    m_armedCalls = 0;
+}
+
+// Insère l'appel dans la case atteinte après delayTicks (>= 1) pas de roue
+void VoipCallGroup::Arm(uint32_t callId, uint64_t delayTicks) {
+    if (delayTicks == 0) {
+        delayTicks = 1;
+    }
+    WheelEntry entry;
+    entry.callId = callId;
+    entry.rounds = (delayTicks - 1) / m_wheelSlots;
+    m_wheel[(m_currentSlot + delayTicks) % m_wheelSlots].push_back(entry);
+    m_armedCalls++;
+}
+
+// Le prochain Tick est posé sur la première case non vide : les cases
+// vides sont sautées sans évènement. Au plus un tour complet est franchi,
+// ce qui laisse le décompte des tours (rounds) exact.
+void VoipCallGroup::ScheduleTick(void) {
+    if (m_armedCalls == 0) {
+        return;
+    }
+    m_tickSteps = m_wheelSlots;
+    for (uint32_t step = 1; step < m_wheelSlots; step++) {
+        if (!m_wheel[(m_currentSlot + step) % m_wheelSlots].empty()) {
+            m_tickSteps = step;
+            break;
+        }
+    }
+    m_tickEvent = Simulator::Schedule(m_tick * m_tickSteps, &VoipCallGroup::Tick, this);
+}
+
+void VoipCallGroup::Tick(void) {
+    m_currentSlot = (m_currentSlot + m_tickSteps) % m_wheelSlots;
+    
+    // La case est vidée avant traitement : un appel réarmé pour un tour
+    // complet revient dans cette même case sans être retraité
+    m_expired.clear();
+    m_expired.swap(m_wheel[m_currentSlot]);
+    
+    Time now = Simulator::Now();
+    for (WheelEntry& entry : m_expired) {
+        if (entry.rounds > 0) {
+            entry.rounds--;
+            m_wheel[m_currentSlot].push_back(entry);
+            continue;
+        }
+        
+        m_armedCalls--;
+        if (now >= m_calls[entry.callId].stopTime) {
+            continue;               // Fin de l'appel
+        }
+        SendFrame(entry.callId);
+        Arm(entry.callId, m_periodTicks);
+    }
+    
+    ScheduleTick();
+}
+
+void VoipCallGroup::SendFrame(uint32_t callId) {
+    PERF_SCOPE("VoipCallGroup::SendFrame");
+    Call& call = m_calls[callId];
+    Ptr<Packet> packet = Create<Packet>(m_payloadSize);   // Un uid par trame
+    packet->AddPacketTag(VoipCallTag(callId));
+    m_sockets[call.destination]->Send(packet);
+    call.packetsSent++;
+    m_packetsSent++;
+}
+
+TypeId FtpTrafficGenerator::GetTypeId(void) {
+    static TypeId tid = TypeId("FtpTrafficGenerator")
+        .SetParent<Application>()
+        .SetGroupName("Applications")
+        .AddConstructor<FtpTrafficGenerator>()
+        .AddAttribute("Pacing",
+                      "Émission par seau à jetons au lieu d'un évènement par paquet",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&FtpTrafficGenerator::m_pacing),
+                      MakeBooleanChecker())
+        .AddAttribute("Rate",
+                      "Débit moyen du seau à jetons pendant les périodes actives",
+                      DataRateValue(DataRate("120Mbps")),
+                      MakeDataRateAccessor(&FtpTrafficGenerator::m_rate),
+                      MakeDataRateChecker())
+        .AddAttribute("BucketSize",
+                      "Taille du seau à jetons (octets émis au plus par réveil, >= 1500)",
+                      UintegerValue(15000),
+                      MakeUintegerAccessor(&FtpTrafficGenerator::m_bucketSize),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("OnTime",
+                      "Durée des périodes d'émission (s)",
+                      StringValue("ns3::ConstantRandomVariable[Constant=0.01]"),
+                      MakePointerAccessor(&FtpTrafficGenerator::m_onTime),
+                      MakePointerChecker<RandomVariableStream>())
+        .AddAttribute("OffTime",
+                      "Durée des silences entre périodes d'émission (s)",
+                      StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
+                      MakePointerAccessor(&FtpTrafficGenerator::m_offTime),
+                      MakePointerChecker<RandomVariableStream>());
+    return tid;
+}
+
+FtpTrafficGenerator::FtpTrafficGenerator()
+    : m_socket(0),
+      m_packetSize(1500),
+      m_burstPackets(100),
+      m_currentBurst(0),
+      m_burstInterval(Seconds(1.0)),
+      m_packetInterval(MicroSeconds(100)),
+      m_packetsSent(0),
+      m_dscp(0),                // Best Effort (DSCP 0)
+      m_pacing(false),
+      m_rate("120Mbps"),        // 1500 bytes / 100 µs, comme le mode rafale
+      m_bucketSize(15000),
+      m_tokens(0.0),
+      m_waitingForSpace(false),
+      m_wakeups(0) {
+}
+
+FtpTrafficGenerator::~FtpTrafficGenerator() {
+    m_socket = 0;
+}
+
+void FtpTrafficGenerator::DoDispose(void) {
+    m_onTime = 0;
+    m_offTime = 0;
+    Application::DoDispose();
+}
+
+uint32_t FtpTrafficGenerator::GetWakeups(void) const {
+    return m_wakeups;
+}
+
+void FtpTrafficGenerator::Setup(Ipv4Address destAddr, uint16_t destPort) {
+    m_destAddr = destAddr;
+    m_destPort = destPort;
+}
+
+void FtpTrafficGenerator::StartApplication(void) {
+    if (!m_socket) {
+        TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+        m_socket = Socket::CreateSocket(GetNode(), tid);
+        
+        InetSocketAddress remote = InetSocketAddress(m_destAddr, m_destPort);
+        m_socket->Connect(remote);
+        
+        // Marquage DSCP Best Effort (0) -> TOS = 0x00
+        m_socket->SetIpTos(0x00);
+        NS_LOG_INFO("FTP: DSCP marqué à BE (0), TOS=0x00");
+    }
+    
+    if (m_pacing) {
+        // Le seau plafonne les jetons : plus petit qu'un paquet, il n'en
+        // accumulerait jamais assez pour émettre
+        NS_ABORT_MSG_IF(m_bucketSize < m_packetSize,
+                        "FtpTrafficGenerator: BucketSize (" << m_bucketSize
+                        << ") inférieur à la taille de paquet (" << m_packetSize << ")");
+        // Sans débit de remplissage, le seau vidé ne se recharge jamais et le
+        // délai d'attente du prochain jeton devient infini
+        NS_ABORT_MSG_IF(m_rate.GetBitRate() == 0, "FtpTrafficGenerator: Rate nul en mode pacing");
+        m_socket->SetSendCallback(MakeCallback(&FtpTrafficGenerator::SendSpaceAvailable, this));
+        m_tokens = m_bucketSize;
+        m_lastRefill = Simulator::Now();
+        StartOnPeriod();
+        return;
+    }
+    
+    SendBurst();
+}
+
+void FtpTrafficGenerator::StopApplication(void) {
+    if (m_sendEvent.IsPending()) {
+        Simulator::Cancel(m_sendEvent);
+    }
+    if (m_socket) {
+        m_socket->Close();
+    }
+}
+
+void FtpTrafficGenerator::SendBurst(void) {
+    NS_LOG_INFO("FTP: Début rafale #" << (m_packetsSent / m_burstPackets + 1) 
+                << " à t=" << Simulator::Now().GetSeconds() << "s");
+    m_currentBurst = 0;
+    SendNextPacket();
+}
+
+void FtpTrafficGenerator::SendNextPacket(void) {
+    PERF_SCOPE("FtpTrafficGenerator::SendNextPacket");
+    if (m_currentBurst < m_burstPackets) {
+        Ptr<Packet> packet = Create<Packet>(m_packetSize);
+        m_socket->Send(packet);
+        m_packetsSent++;
+        m_currentBurst++;
+        
+        m_sendEvent = Simulator::Schedule(m_packetInterval, 
+                                          &FtpTrafficGenerator::SendNextPacket, this);
+    } else {
+        NS_LOG_INFO("FTP: Rafale terminée (" << m_burstPackets 
+                    << " paquets, total: " << m_packetsSent << ")");
+        m_sendEvent = Simulator::Schedule(m_burstInterval, 
+                                          &FtpTrafficGenerator::SendBurst, this);
+    }
+}
+
+void FtpTrafficGenerator::StartOnPeriod(void) {
+    m_onUntil = Simulator::Now() + Seconds(m_onTime->GetValue());
+    PacedSend();
+}
+
+void FtpTrafficGenerator::Refill(void) {
+    Time now = Simulator::Now();
+    m_tokens += m_rate.GetBitRate() / 8.0 * (now - m_lastRefill).GetSeconds();
+    m_tokens = std::min<double>(m_tokens, m_bucketSize);
+    m_lastRefill = now;
+}
+
+// Émet autant de paquets que le seau et la socket le permettent, puis
+// programme un seul réveil : à la fin de la période active, quand le seau
+// est de nouveau plein, ou sur notification de place libre dans la socket
+void FtpTrafficGenerator::PacedSend(void) {
+    PERF_SCOPE("FtpTrafficGenerator::PacedSend");
+    m_wakeups++;
+    m_waitingForSpace = false;
+    Refill();
+    
+    Time now = Simulator::Now();
+    while (now < m_onUntil && m_tokens >= m_packetSize) {
+        if (m_socket->GetTxAvailable() < m_packetSize ||
+            m_socket->Send(Create<Packet>(m_packetSize)) < 0) {
+            // Réveil de secours si la socket ne notifie jamais (UDP)
+            m_waitingForSpace = true;
+            m_sendEvent = Simulator::Schedule(Seconds(m_packetSize * 8.0 / m_rate.GetBitRate()),
+                                              &FtpTrafficGenerator::PacedSend, this);
+            return;
+        }
+        m_tokens -= m_packetSize;
+        m_packetsSent++;
+    }
+    
+    if (now >= m_onUntil) {
+        m_sendEvent = Simulator::Schedule(Seconds(m_offTime->GetValue()),
+                                          &FtpTrafficGenerator::StartOnPeriod, this);
+        return;
+    }
+    
+    double target = std::max<double>(m_bucketSize, m_packetSize);
+    Time refill = Seconds((target - m_tokens) * 8.0 / m_rate.GetBitRate());
+    Time wakeup = std::min(refill, m_onUntil - now);
+    m_sendEvent = Simulator::Schedule(wakeup, &FtpTrafficGenerator::PacedSend, this);
+}
+
+void FtpTrafficGenerator::SendSpaceAvailable(Ptr<Socket> socket, uint32_t available) {
+    if (m_waitingForSpace && available >= m_packetSize) {
+        Simulator::Cancel(m_sendEvent);
+        m_sendEvent = Simulator::ScheduleNow(&FtpTrafficGenerator::PacedSend, this);
+    }
+}
+
+// ========== QUESTION 3: COLLECTEUR DE MÉTRIQUES PERSONNALISÉ ==========
+
+TypeId QosTimestampTag::GetTypeId(void) {
+    static TypeId tid = TypeId("QosTimestampTag")
+        .SetParent<Tag>()
+        .SetGroupName("Applications")
+        .AddConstructor<QosTimestampTag>();
+    return tid;
+}
+
+TypeId QosTimestampTag::GetInstanceTypeId(void) const {
+    return GetTypeId();
+}
+
+uint32_t QosTimestampTag::GetSerializedSize(void) const {
+    return 17;
+}
+
+void QosTimestampTag::Serialize(TagBuffer i) const {
+    i.WriteU8(m_class);
+    i.WriteU64(m_flowKey);
+    i.WriteU64(m_txTime.GetTimeStep());
+}
+
+void QosTimestampTag::Deserialize(TagBuffer i) {
+    m_class = i.ReadU8();
+    m_flowKey = i.ReadU64();
+    m_txTime = TimeStep(i.ReadU64());
+}
+
+void QosTimestampTag::Print(std::ostream& os) const {
+    os << "class=" << uint32_t(m_class) << " flow=" << m_flowKey << " txTime=" << m_txTime;
+}
+
+QosTimestampTag::QosTimestampTag()
+    : m_class(QOS_OTHER),
+      m_flowKey(0) {
+}
+
+QosTimestampTag::QosTimestampTag(QosClass qosClass, uint64_t flowKey, Time txTime)
+    : m_class(qosClass),
+      m_flowKey(flowKey),
+      m_txTime(txTime) {
+}
+
+QosClass QosTimestampTag::GetClass(void) const {
+    return QosClass(m_class);
+}
+
+uint64_t QosTimestampTag::GetFlowKey(void) const {
+    return m_flowKey;
+}
+
+Time QosTimestampTag::GetTxTime(void) const {
+    return m_txTime;
+}
+
+QosMetricsCollector::QosMetricsCollector()
+    : m_exporter(nullptr),
+      m_online(false) {
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        m_classMetrics[c].className = ClassName(QosClass(c));
+    }
+}
+
+const char* QosMetricsCollector::ClassName(QosClass qosClass) {
+    switch (qosClass) {
+        case QOS_VOIP: return "VoIP";
+        case QOS_FTP: return "FTP";
+        default: return "Other";
+    }
+}
+
+QosClass QosMetricsCollector::ClassifyPort(uint16_t destinationPort) {
+    // Classification basée sur le port de destination
+    if (destinationPort == 5060) {
+        return QOS_VOIP;
+    } else if (destinationPort == 21 || destinationPort == 9) {
+        return QOS_FTP;
+    }
+    return QOS_OTHER;
+}
+
+QosClass QosMetricsCollector::ClassifyFlow(
+    const Ipv4FlowClassifier::FiveTuple& tuple) {
+    return ClassifyPort(tuple.destinationPort);
+}
+
+void QosMetricsCollector::EnableOnline(Ptr<Node> client, Ptr<Node> server) {
+    m_online = true;
+    
+    // Le tag doit être posé sur le paquet réellement transmis : la trace
+    // Ipv4L3Protocol/Tx ne fournit qu'une copie, on utilise donc MacTx.
+    for (uint32_t i = 0; i < client->GetNDevices(); i++) {
+        client->GetDevice(i)->TraceConnectWithoutContext("MacTx",
+            MakeCallback(&QosMetricsCollector::DeviceTx, this));
+    }
+    server->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext("Rx",
+        MakeCallback(&QosMetricsCollector::PacketReceived, this));
+}
+
+void QosMetricsCollector::StartSampling(Time interval) {
+    m_sampleInterval = interval;
+    Simulator::Schedule(m_sampleInterval, &QosMetricsCollector::Sample, this);
+}
+
+void QosMetricsCollector::Sample(void) {
+    PrintSummary();
+    Simulator::Schedule(m_sampleInterval, &QosMetricsCollector::Sample, this);
+}
+
+void QosMetricsCollector::StartExport(MetricsExporter* exporter, Time interval) {
+    m_exporter = exporter;
+    m_exportInterval = interval;
+    Simulator::Schedule(m_exportInterval, &QosMetricsCollector::ExportSample, this);
+}
+
+// Un enregistrement SERIES_CLASS par classe active ; pas de formatage ici,
+// l'exporteur écrit depuis son propre thread
+void QosMetricsCollector::ExportSample(void) {
+    MetricsRecord record;
+    record.timeNs = Simulator::Now().GetNanoSeconds();
+    record.series = SERIES_CLASS;
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        const TrafficClassMetrics& m = m_classMetrics[c];
+        if (IsEmpty(m)) continue;
+        DerivedMetrics d = GetDerivedMetrics(QosClass(c));
+        
+        record.id = c;
+        record.values[0] = m.txPackets;
+        record.values[1] = m.rxPackets;
+        record.values[2] = d.lossRate;
+        record.values[3] = d.avgDelay;
+        record.values[4] = d.avgJitter;
+        record.values[5] = d.throughput;
+        m_exporter->Append(record);
+    }
+    Simulator::Schedule(m_exportInterval, &QosMetricsCollector::ExportSample, this);
+}
+
+void QosMetricsCollector::DeviceTx(Ptr<const Packet> packet) {
+    Ipv4Header ipHeader;
+    if (packet->PeekHeader(ipHeader) == 0 ||
+        ipHeader.GetProtocol() != UdpL4Protocol::PROT_NUMBER) {
+        return;
+    }
+    
+    // Ports UDP lus à offset fixe derrière l'en-tête IP (RFC 768)
+    uint8_t buf[64];
+    uint32_t ipLength = ipHeader.GetSerializedSize();
+    if (ipLength + 4 > sizeof(buf) || packet->CopyData(buf, ipLength + 4) != ipLength + 4) {
+        return;
+    }
+    uint16_t srcPort = (uint16_t(buf[ipLength]) << 8) | buf[ipLength + 1];
+    uint16_t dstPort = (uint16_t(buf[ipLength + 2]) << 8) | buf[ipLength + 3];
+    
+    // Les appels multiplexés d'un VoipCallGroup partagent le port source :
+    // l'identifiant d'appel les distingue
+    uint64_t flowKey = uint64_t(srcPort) << 32;
+    VoipCallTag callTag;
+    if (packet->PeekPacketTag(callTag)) {
+        flowKey |= callTag.GetCallId();
+    }
+    
+    QosClass qosClass = ClassifyPort(dstPort);
+    TrafficClassMetrics& metrics = m_classMetrics[qosClass];
+    if (metrics.txPackets == 0) {
+        metrics.firstPacketTime = Simulator::Now();
+    }
+    metrics.txPackets++;
+    packet->AddPacketTag(QosTimestampTag(qosClass, flowKey, Simulator::Now()));
+}
+
+void QosMetricsCollector::PacketReceived(Ptr<const Packet> packet, Ptr<Ipv4> ipv4,
+                                         uint32_t interface) {
+    PERF_SCOPE("QosMetricsCollector::PacketReceived");
+    QosTimestampTag tag;
+    if (!packet->PeekPacketTag(tag)) {
+        return;
+    }
+    
+    double delay = (Simulator::Now() - tag.GetTxTime()).GetNanoSeconds() / 1e6; // ms
+    
+    TrafficClassMetrics& metrics = m_classMetrics[tag.GetClass()];
+    metrics.rxPackets++;
+    metrics.totalBytes += packet->GetSize();       // Octets IP, comme FlowMonitor
+    metrics.totalDelay += delay;
+    metrics.lastPacketTime = Simulator::Now();
+    // Les paquets non encore reçus comptent comme perdus jusqu'à leur arrivée
+    metrics.lostPackets = metrics.txPackets - metrics.rxPackets;
+    
+    auto flow = m_flowLastDelay.find(tag.GetFlowKey());
+    if (flow == m_flowLastDelay.end()) {
+        m_flowLastDelay.emplace(tag.GetFlowKey(), delay);
+        metrics.flows++;
+    } else {
+        CalculateJitter(metrics, flow->second, delay);
+    }
+}
+
+void QosMetricsCollector::CalculateJitter(TrafficClassMetrics& metrics, double& previousDelay,
+                                          double currentDelay) {
+    // Gigue = variation du délai entre deux paquets consécutifs d'un même flux
+    metrics.totalJitter += std::abs(currentDelay - previousDelay);
+    metrics.jitterSamples++;
+    previousDelay = currentDelay;
+}
+
+void QosMetricsCollector::RecordFlow(FlowId flowId, 
+                                     const FlowMonitor::FlowStats& stats,
+                                     const Ipv4FlowClassifier::FiveTuple& tuple) {
+    TrafficClassMetrics& metrics = m_classMetrics[ClassifyFlow(tuple)];
+    
+    metrics.flows++;
+    metrics.txPackets += stats.txPackets;
+    metrics.rxPackets += stats.rxPackets;
+    metrics.lostPackets += stats.lostPackets;
+    metrics.totalBytes += stats.rxBytes;
+    
+    if (stats.rxPackets > 0) {
+        double avgDelay = stats.delaySum.GetMilliSeconds() / stats.rxPackets;
+        metrics.totalDelay += avgDelay * stats.rxPackets;
+        
+        // Calcul de la gigue (jitter)
+        if (stats.rxPackets > 1) {
+            // Jitter = variation moyenne du délai
+            metrics.totalJitter += stats.jitterSum.GetMilliSeconds();
+            metrics.jitterSamples += stats.rxPackets - 1;
+        }
+    }
+    
+    if (stats.timeFirstTxPacket < metrics.firstPacketTime || 
+        metrics.firstPacketTime.IsZero()) {
+        metrics.firstPacketTime = stats.timeFirstTxPacket;
+    }
+    if (stats.timeLastRxPacket > metrics.lastPacketTime) {
+        metrics.lastPacketTime = stats.timeLastRxPacket;
+    }
+}
+
+const QosMetricsCollector::TrafficClassMetrics&
+QosMetricsCollector::GetClassMetrics(QosClass qosClass) const {
+    return m_classMetrics[qosClass];
+}
+
+QosMetricsCollector::DerivedMetrics
+QosMetricsCollector::GetDerivedMetrics(QosClass qosClass) const {
+    const TrafficClassMetrics& m = m_classMetrics[qosClass];
+    DerivedMetrics d;
+    d.lossRate = (m.txPackets > 0) ? (100.0 * m.lostPackets / m.txPackets) : 0.0;
+    d.avgDelay = (m.rxPackets > 0) ? (m.totalDelay / m.rxPackets) : 0.0;
+    d.avgJitter = (m.jitterSamples > 0) ? (m.totalJitter / m.jitterSamples) : 0.0;
+    d.duration = (m.lastPacketTime - m.firstPacketTime).GetSeconds();
+    d.throughput = (d.duration > 0) ? (8.0 * m.totalBytes / d.duration / 1000000.0) : 0.0;
+    return d;
+}
+
+bool QosMetricsCollector::IsEmpty(const TrafficClassMetrics& metrics) const {
+    return metrics.txPackets == 0 && metrics.rxPackets == 0;
+}
+
+void QosMetricsCollector::PrintSummary() {
+    NS_LOG_UNCOND("[" << Simulator::Now().GetSeconds() << "s] Métriques QoS en cours:");
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        const TrafficClassMetrics& m = m_classMetrics[c];
+        if (IsEmpty(m)) continue;
+        DerivedMetrics d = GetDerivedMetrics(QosClass(c));
+        
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer),
+                 "  %-6s délai %6.2f ms | gigue %6.2f ms | perte %6.2f %% | débit %6.2f Mbps",
+                 m.className.c_str(), d.avgDelay, d.avgJitter, d.lossRate, d.throughput);
+        NS_LOG_UNCOND(buffer);
+    }
+}
+
+void QosMetricsCollector::PrintReport() {
+    NS_LOG_UNCOND("\n╔════════════════════════════════════════════════════════════════╗");
+    NS_LOG_UNCOND("║          RAPPORT DE MÉTRIQUES QoS PAR CLASSE                  ║");
+    NS_LOG_UNCOND("╚════════════════════════════════════════════════════════════════╝\n");
+    
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        const TrafficClassMetrics& m = m_classMetrics[c];
+        if (IsEmpty(m)) continue;
+        DerivedMetrics d = GetDerivedMetrics(QosClass(c));
+        
+        NS_LOG_UNCOND("┌─ Classe de Trafic: " << m.className << " ─────────────────");
+        NS_LOG_UNCOND("│");
+        NS_LOG_UNCOND("│  📊 STATISTIQUES DE PAQUETS:");
+        NS_LOG_UNCOND("│     • Flux / appels       : " << m.flows);
+        NS_LOG_UNCOND("│     • Paquets transmis    : " << m.txPackets);
+        NS_LOG_UNCOND("│     • Paquets reçus       : " << m.rxPackets);
+        NS_LOG_UNCOND("│     • Paquets perdus      : " << m.lostPackets);
+        NS_LOG_UNCOND("│     • Taux de perte       : " << d.lossRate << " %");
+        NS_LOG_UNCOND("│");
+        NS_LOG_UNCOND("│  ⏱️  MÉTRIQUES DE LATENCE:");
+        NS_LOG_UNCOND("│     • Délai moyen         : " << d.avgDelay << " ms");
+        NS_LOG_UNCOND("│     • Gigue moyenne       : " << d.avgJitter << " ms");
+        NS_LOG_UNCOND("│");
+        NS_LOG_UNCOND("│  🚀 PERFORMANCE:");
+        NS_LOG_UNCOND("│     • Débit               : " << d.throughput << " Mbps");
+        NS_LOG_UNCOND("│     • Octets reçus        : " << m.totalBytes);
+        NS_LOG_UNCOND("│     • Durée               : " << d.duration << " s");
+        NS_LOG_UNCOND("└──────────────────────────────────────────────────────\n");
+    }
+    
+    // Tableau comparatif
+    NS_LOG_UNCOND("╔══════════════════════════════════════════════════════════════════╗");
+    NS_LOG_UNCOND("║                    TABLEAU COMPARATIF                            ║");
+    NS_LOG_UNCOND("╠════════════╦══════════╦══════════╦═══════════╦═══════════════════╣");
+    NS_LOG_UNCOND("║   Classe   ║  Délai   ║  Gigue   ║ Perte (%) ║   Débit (Mbps)   ║");
+    NS_LOG_UNCOND("╠════════════╬══════════╬══════════╬═══════════╬═══════════════════╣");
+    
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        const TrafficClassMetrics& m = m_classMetrics[c];
+        if (IsEmpty(m)) continue;
+        DerivedMetrics d = GetDerivedMetrics(QosClass(c));
+        
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), 
+                 "║ %-10s ║ %6.2f ms ║ %6.2f ms ║  %6.2f   ║      %6.2f       ║",
+                 m.className.c_str(), d.avgDelay, d.avgJitter, d.lossRate, d.throughput);
+        NS_LOG_UNCOND(buffer);
+    }
+    
+    NS_LOG_UNCOND("╚════════════╩══════════╩══════════╩═══════════╩═══════════════════╝\n");
+}
+
+void QosMetricsCollector::ExportToCsv(const std::string& filename) {
+    std::ofstream file(filename);
+    file << "Classe,Paquets_TX,Paquets_RX,Paquets_Perdus,Taux_Perte_%,";
+    file << "Delai_Moyen_ms,Gigue_Moyenne_ms,Debit_Mbps\n";
+    
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        const TrafficClassMetrics& m = m_classMetrics[c];
+        if (IsEmpty(m)) continue;
+        DerivedMetrics d = GetDerivedMetrics(QosClass(c));
+        
+        file << m.className << "," << m.txPackets << "," << m.rxPackets << ","
+             << m.lostPackets << "," << d.lossRate << "," << d.avgDelay << ","
+             << d.avgJitter << "," << d.throughput << "\n";
+    }
+    
+    file.close();
+    NS_LOG_UNCOND("Métriques exportées vers: " << filename);
+}
+
+} // namespace ns3
@@ -0,0 +1,298 @@
+/*
+ * Générateurs de trafic et collecteur QoS de l'exercice 2, partagés par les
+ * scénarios de wan-lab via la bibliothèque scratch-wan-lab-lib :
+ * - VoipTrafficGenerator, VoipCallGroup : trafic voix marqué EF (DSCP 46)
+ * - FtpTrafficGenerator : rafales de données marquées BE (DSCP 0)
+ * - QosMetricsCollector : perte, délai, gigue et débit par classe de trafic
+ */
+
+#ifndef QOS_TRAFFIC_H
+#define QOS_TRAFFIC_H
+
+#include "metrics-exporter.h"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// ========== QUESTION 1: GÉNÉRATEURS DE TRAFIC AVEC MARQUAGE DSCP ==========
+
+// Codecs voix : charge utile par trame de 20 ms
+enum VoipCodec {
+    CODEC_G711,                 // 64 kbps -> 160 bytes
+    CODEC_G729,                 // 8 kbps  -> 20 bytes
+    CODEC_OPUS                  // 32 kbps -> 80 bytes (mode voix)
+};
+
+uint32_t CodecPayloadSize(VoipCodec codec);
+
+// Classe pour trafic VoIP
+class VoipTrafficGenerator : public Application {
+public:
+    static TypeId GetTypeId(void);
+    VoipTrafficGenerator();
+    virtual ~VoipTrafficGenerator();
+    
+    void Setup(Ipv4Address destAddr, uint16_t destPort);
+    
+protected:
+    virtual void DoDispose(void);
+    
+private:
+    virtual void StartApplication(void);
+    virtual void StopApplication(void);
+    void SendPacket(void);
+    
+    Ptr<Socket> m_socket;
+    Ipv4Address m_destAddr;
+    uint16_t m_destPort;
+    VoipCodec m_codec;
+    uint32_t m_packetSize;      // 160 bytes (G.711 codec)
+    Time m_interval;            // 20ms (50 pps)
+    EventId m_sendEvent;
+    uint32_t m_packetsSent;
+    uint8_t m_dscp;             // DSCP marking
+};
+
+// Identifiant d'appel posé par VoipCallGroup sur chaque trame, pour que le
+// collecteur suive séparément les appels multiplexés sur une même socket
+class VoipCallTag : public Tag {
+public:
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(TagBuffer i) const;
+    virtual void Deserialize(TagBuffer i);
+    virtual void Print(std::ostream& os) const;
+    
+    VoipCallTag();
+    explicit VoipCallTag(uint32_t callId);
+    
+    uint32_t GetCallId(void) const;
+    
+private:
+    uint32_t m_callId;
+};
+
+// Source VoIP agrégée : N appels logiques multiplexés sur une socket par
+// destination. Les trames de tous les appels sont ordonnancées par une roue
+// temporelle hachée (une case par TickResolution) : un seul évènement en
+// file par groupe quel que soit le nombre d'appels. Les instants d'émission
+// sont arrondis à la résolution de la roue.
+class VoipCallGroup : public Application {
+public:
+    static TypeId GetTypeId(void);
+    VoipCallGroup();
+    virtual ~VoipCallGroup();
+    
+    void AddDestination(Ipv4Address destAddr, uint16_t destPort);
+    uint32_t GetActiveCalls(void) const;
+    uint64_t GetPacketsSent(void) const;
+    
+protected:
+    virtual void DoDispose(void);
+    
+private:
+    struct Call {
+        uint32_t destination;   // Index dans m_sockets
+        Time stopTime;
+        uint32_t packetsSent;
+    };
+    
+    struct WheelEntry {
+        uint32_t callId;
+        uint32_t rounds;        // Tours de roue restants avant l'échéance
+    };
+    
+    virtual void StartApplication(void);
+    virtual void StopApplication(void);
+    void Arm(uint32_t callId, uint64_t delayTicks);
+    void ScheduleTick(void);
+    void Tick(void);
+    void SendFrame(uint32_t callId);
+    
+    std::vector<Ipv4Address> m_destAddrs;
+    std::vector<uint16_t> m_destPorts;
+    std::vector<Ptr<Socket>> m_sockets;
+    std::vector<Call> m_calls;
+    std::vector<std::vector<WheelEntry>> m_wheel;
+    std::vector<WheelEntry> m_expired;      // Case en cours de traitement
+    uint32_t m_currentSlot;
+    uint32_t m_tickSteps;                   // Cases franchies au prochain Tick
+    uint32_t m_armedCalls;                  // Appels présents dans la roue
+    uint64_t m_periodTicks;
+    EventId m_tickEvent;
+    Ptr<UniformRandomVariable> m_jitter;
+    uint32_t m_payloadSize;
+    
+    uint32_t m_numCalls;
+    VoipCodec m_codec;
+    Time m_interval;            // 20ms par trame
+    Time m_tick;                // Résolution de la roue
+    uint32_t m_wheelSlots;
+    Time m_startJitter;         // Début de chaque appel dans [0, StartJitter]
+    Time m_callDuration;        // 0 = jusqu'à l'arrêt du groupe
+    Time m_stopJitter;          // Fin anticipée de chaque appel dans [0, StopJitter]
+    uint64_t m_packetsSent;
+};
+
+// Classe pour trafic FTP (bulk data)
+class FtpTrafficGenerator : public Application {
+public:
+    static TypeId GetTypeId(void);
+    FtpTrafficGenerator();
+    virtual ~FtpTrafficGenerator();
+    
+    void Setup(Ipv4Address destAddr, uint16_t destPort);
+    uint32_t GetWakeups(void) const;
+    
+protected:
+    virtual void DoDispose(void);
+    
+private:
+    virtual void StartApplication(void);
+    virtual void StopApplication(void);
+    void SendBurst(void);
+    void SendNextPacket(void);
+    
+    // Mode à seau à jetons : chaque réveil émet tout ce que le seau permet
+    void StartOnPeriod(void);
+    void Refill(void);
+    void PacedSend(void);
+    void SendSpaceAvailable(Ptr<Socket> socket, uint32_t available);
+    
+    Ptr<Socket> m_socket;
+    Ipv4Address m_destAddr;
+    uint16_t m_destPort;
+    uint32_t m_packetSize;      // 1500 bytes (MTU-sized)
+    uint32_t m_burstPackets;    // Nombre de paquets par rafale
+    uint32_t m_currentBurst;    // Compteur de rafale
+    Time m_burstInterval;       // Intervalle entre rafales
+    Time m_packetInterval;      // Intervalle entre paquets dans une rafale
+    EventId m_sendEvent;
+    uint32_t m_packetsSent;
+    uint8_t m_dscp;
+    
+    bool m_pacing;
+    DataRate m_rate;            // Débit moyen de remplissage du seau
+    uint32_t m_bucketSize;      // Rafale maximale (octets)
+    Ptr<RandomVariableStream> m_onTime;
+    Ptr<RandomVariableStream> m_offTime;
+    double m_tokens;            // Octets disponibles
+    Time m_lastRefill;
+    Time m_onUntil;             // Fin de la période d'émission en cours
+    bool m_waitingForSpace;     // Bloqué par la socket, réveil par SetSendCallback
+    uint32_t m_wakeups;
+};
+
+// ========== QUESTION 3: COLLECTEUR DE MÉTRIQUES PERSONNALISÉ ==========
+
+// Classes de trafic suivies par le collecteur (index du tableau d'accumulateurs)
+enum QosClass {
+    QOS_VOIP,
+    QOS_FTP,
+    QOS_OTHER,
+    NUM_QOS_CLASSES
+};
+
+// Tag posé à l'émission par le collecteur en mode en ligne : classe,
+// identifiant du flux pour la gigue (port source, et appel pour un
+// VoipCallGroup) et instant d'émission.
+class QosTimestampTag : public Tag {
+public:
+    static TypeId GetTypeId(void);
+    virtual TypeId GetInstanceTypeId(void) const;
+    virtual uint32_t GetSerializedSize(void) const;
+    virtual void Serialize(TagBuffer i) const;
+    virtual void Deserialize(TagBuffer i);
+    virtual void Print(std::ostream& os) const;
+    
+    QosTimestampTag();
+    QosTimestampTag(QosClass qosClass, uint64_t flowKey, Time txTime);
+    
+    QosClass GetClass(void) const;
+    uint64_t GetFlowKey(void) const;
+    Time GetTxTime(void) const;
+    
+private:
+    uint8_t m_class;
+    uint64_t m_flowKey;
+    Time m_txTime;
+};
+
+class QosMetricsCollector {
+public:
+    struct TrafficClassMetrics {
+        std::string className;
+        uint32_t txPackets;
+        uint32_t rxPackets;
+        uint32_t lostPackets;
+        double totalDelay;
+        double totalJitter;
+        uint32_t jitterSamples;     // Nombre d'écarts de délai cumulés
+        uint32_t flows;             // Flux (ou appels) distincts observés
+        uint64_t totalBytes;
+        Time firstPacketTime;
+        Time lastPacketTime;
+        
+        TrafficClassMetrics() : className(""), txPackets(0), rxPackets(0), 
+            lostPackets(0), totalDelay(0.0), totalJitter(0.0), 
+            jitterSamples(0), flows(0), totalBytes(0) {}
+    };
+    
+    // Métriques dérivées, calculées à la demande à partir des sommes courantes
+    struct DerivedMetrics {
+        double lossRate;            // %
+        double avgDelay;            // ms
+        double avgJitter;           // ms
+        double duration;            // s
+        double throughput;          // Mbps
+    };
+    
+    QosMetricsCollector();
+    
+    // Mode en ligne : tag à l'émission (MacTx du client), agrégation à la
+    // réception (Ipv4L3Protocol/Rx du serveur). Remplace RecordFlow.
+    void EnableOnline(Ptr<Node> client, Ptr<Node> server);
+    void StartSampling(Time interval);
+    void StartExport(MetricsExporter* exporter, Time interval);
+    
+    void RecordFlow(FlowId flowId, const FlowMonitor::FlowStats& stats, 
+                    const Ipv4FlowClassifier::FiveTuple& tuple);
+    const TrafficClassMetrics& GetClassMetrics(QosClass qosClass) const;
+    DerivedMetrics GetDerivedMetrics(QosClass qosClass) const;
+    void PrintSummary();
+    void PrintReport();
+    void ExportToCsv(const std::string& filename);
+    
+    static const char* ClassName(QosClass qosClass);
+    
+private:
+    TrafficClassMetrics m_classMetrics[NUM_QOS_CLASSES];
+    std::unordered_map<uint64_t, double> m_flowLastDelay;   // clé de flux -> dernier délai (ms)
+    Time m_sampleInterval;
+    MetricsExporter* m_exporter;
+    Time m_exportInterval;
+    bool m_online;
+    
+    static QosClass ClassifyPort(uint16_t destinationPort);
+    QosClass ClassifyFlow(const Ipv4FlowClassifier::FiveTuple& tuple);
+    void CalculateJitter(TrafficClassMetrics& metrics, double& previousDelay, double currentDelay);
+    void DeviceTx(Ptr<const Packet> packet);
+    void PacketReceived(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+    void Sample(void);
+    void ExportSample(void);
+    bool IsEmpty(const TrafficClassMetrics& metrics) const;
+};
+
+} // namespace ns3
+
+#endif // QOS_TRAFFIC_H
@@ -0,0 +1,1115 @@
+/*
+ * Composants PBR / SD-WAN de l'exercice 5 (voir sdwan-components.h)
+ */
+
+#include "sdwan-components.h"
+
+#include "event-log.h"
+#include "perf-counters.h"
+
+#include <iostream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("SdwanComponents");
+
+// ========================================
+// CLASSE: PathMetricsMonitor
+// ========================================
+
+TypeId PathMetricsMonitor::GetTypeId() {
+    static TypeId tid = TypeId("PathMetricsMonitor")
+        .SetParent<Object>()
+        .SetGroupName("Applications")
+        .AddAttribute("LatencyWindow",
+                      "Nombre d'échantillons de la moyenne mobile de latence",
+                      UintegerValue(100),
+                      MakeUintegerAccessor(&PathMetricsMonitor::m_latencyWindowSize),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("EwmaAlpha",
+                      "Coefficient de lissage de la latence exponentielle",
+                      DoubleValue(0.1),
+                      MakeDoubleAccessor(&PathMetricsMonitor::m_ewmaAlpha),
+                      MakeDoubleChecker<double>(0.0, 1.0))
+        .AddAttribute("UseTxTag",
+                      "Horodater les paquets avec un TxTimestampTag à l'émission",
+                      BooleanValue(true),
+                      MakeBooleanAccessor(&PathMetricsMonitor::m_useTxTag),
+                      MakeBooleanChecker())
+        .AddAttribute("TxTableSize",
+                      "Nombre d'entrées de la table de secours (arrondi à une puissance de 2)",
+                      UintegerValue(4096),
+                      MakeUintegerAccessor(&PathMetricsMonitor::m_txTableSize),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("TxTableMaxAge",
+                      "Durée de validité d'une entrée de la table de secours",
+                      TimeValue(Seconds(1.0)),
+                      MakeTimeAccessor(&PathMetricsMonitor::m_txTableMaxAge),
+                      MakeTimeChecker())
+        .AddAttribute("SketchEpoch",
+                      "Durée d'une époque des esquisses de quantiles (délai et gigue)",
+                      TimeValue(Seconds(10.0)),
+                      MakeTimeAccessor(&PathMetricsMonitor::m_sketchEpoch),
+                      MakeTimeChecker())
+        .AddAttribute("BandwidthInterval",
+                      "Fenêtre de mesure du débit par interface",
+                      TimeValue(Seconds(1.0)),
+                      MakeTimeAccessor(&PathMetricsMonitor::m_bandwidthInterval),
+                      MakeTimeChecker())
+        .AddAttribute("StaleAge",
+                      "Durée sans échantillon après laquelle les métriques d'une interface expirent (0 = jamais)",
+                      TimeValue(Seconds(0)),
+                      MakeTimeAccessor(&PathMetricsMonitor::m_staleAge),
+                      MakeTimeChecker());
+    return tid;
+}
+
+PathMetricsMonitor::PathMetricsMonitor()
+    : m_nextSubscriptionId(0),
+      m_latencyWindowSize(100),
+      m_ewmaAlpha(0.1),
+      m_useTxTag(true),
+      m_txTableSize(4096),
+      m_txTableMaxAge(Seconds(1.0)),
+      m_sketchEpoch(Seconds(10.0)),
+      m_bandwidthInterval(Seconds(1.0)),
+      m_staleAge(Seconds(0)),
+      m_exporter(nullptr) {
+    NS_LOG_FUNCTION(this);
+}
+
+PathMetricsMonitor::~PathMetricsMonitor() {
+    NS_LOG_FUNCTION(this);
+}
+
+void PathMetricsMonitor::Initialize() {
+    // Initialiser les métriques pour chaque interface
+    PathMetrics metrics;
+    metrics.lastUpdateTime = Simulator::Now();
+    m_interfaceMetrics.assign(5, metrics);
+    m_lastBandwidthSample = Simulator::Now();
+    
+    if (m_staleAge.IsStrictlyPositive()) {
+        m_staleEvent = Simulator::Schedule(m_staleAge / 2, &PathMetricsMonitor::ExpireStaleMetrics, this);
+    }
+}
+
+void PathMetricsMonitor::EnableLatencyTracking(Ptr<Node> node) {
+    if (m_useTxTag) {
+        // Le tag doit être posé sur le paquet réellement transmis : la trace
+        // Ipv4L3Protocol/Tx ne fournit qu'une copie, on utilise donc MacTx.
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+            Ptr<NetDevice> device = node->GetDevice(i);
+            int32_t interface = ipv4->GetInterfaceForDevice(device);
+            if (interface < 0) continue;
+            // L'index d'interface est lié au callback : rien à analyser par paquet
+            device->TraceConnectWithoutContext("MacTx",
+                MakeBoundCallback(&PathMetricsMonitor::DeviceTx, this,
+                                  static_cast<uint32_t>(interface)));
+        }
+        return;
+    }
+    
+    // Connecter aux traces Ipv4L3Protocol
+    std::ostringstream oss;
+    oss << "/NodeList/" << node->GetId() << "/$ns3::Ipv4L3Protocol/Tx";
+    Config::Connect(oss.str(), MakeCallback(&PathMetricsMonitor::PacketSent, this));
+}
+
+void PathMetricsMonitor::EnableReceiveTracking(Ptr<Node> node) {
+    std::ostringstream oss;
+    oss << "/NodeList/" << node->GetId() << "/$ns3::Ipv4L3Protocol/Rx";
+    Config::Connect(oss.str(), MakeCallback(&PathMetricsMonitor::PacketReceivedTrace, this));
+}
+
+void PathMetricsMonitor::PacketSent(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface) {
+    PERF_SCOPE("PathMetricsMonitor::PacketSent");
+    RecordTx(packet, interface);
+}
+
+void PathMetricsMonitor::DeviceTx(PathMetricsMonitor* monitor, uint32_t interface,
+                                  Ptr<const Packet> packet) {
+    PERF_SCOPE("PathMetricsMonitor::DeviceTx");
+    // Un paquet déjà horodaté par un saut précédent garde son tag d'origine
+    TxTimestampTag tag;
+    if (!packet->PeekPacketTag(tag)) {
+        packet->AddPacketTag(TxTimestampTag(Simulator::Now(), interface));
+    }
+    monitor->RecordTx(packet, interface);
+}
+
+void PathMetricsMonitor::PacketReceived(Ptr<const Packet> packet) {
+    PERF_SCOPE("PathMetricsMonitor::PacketReceived");
+    Time txTime;
+    uint32_t interface;
+    
+    TxTimestampTag tag;
+    if (m_useTxTag && packet->PeekPacketTag(tag)) {
+        txTime = tag.GetTxTime();
+        interface = tag.GetInterface();
+    } else if (!LookupTx(packet->GetUid(), txTime, interface)) {
+        return;
+    }
+    
+    Time latency = Simulator::Now() - txTime;
+    double latencyUs = latency.GetNanoSeconds() / 1000.0;
+    double latencyMs = latencyUs / 1000.0;
+    
+    PathSketches& sketches = m_sketches[interface];
+    sketches.delay.Insert(latencyUs, m_sketchEpoch);
+    uint64_t flow = FlowOf(packet);
+    auto last = sketches.lastDelayUs.find(flow);
+    if (last != sketches.lastDelayUs.end()) {
+        sketches.jitter.Insert(std::abs(latencyUs - last->second), m_sketchEpoch);
+        last->second = latencyUs;
+    } else {
+        if (sketches.lastDelayUs.size() >= PathSketches::MAX_FLOWS) {
+            sketches.lastDelayUs.clear();
+        }
+        sketches.lastDelayUs.emplace(flow, latencyUs);
+    }
+    
+    // Mettre à jour la fenêtre glissante (O(1) quelle que soit sa taille)
+    LatencyWindow& window = m_latencyHistory[interface];
+    if (window.samples.empty()) {
+        window.Resize(m_latencyWindowSize);
+    }
+    window.Push(latencyMs, m_ewmaAlpha);
+    
+    PathMetrics& metrics = MetricsFor(interface);
+    metrics.latency = window.Mean();
+    metrics.latencyEwma = window.ewma;
+    metrics.packetsReceived++;
+    metrics.lastUpdateTime = Simulator::Now();
+    
+    auto subs = m_subscriptions.find(interface);
+    if (subs != m_subscriptions.end()) {
+        CheckThresholds(interface, metrics, subs->second);
+    }
+}
+
+uint32_t PathMetricsMonitor::SubscribeThreshold(uint32_t interface, double low, double high, double percentile,
+                                                Callback<void, uint32_t, bool> callback) {
+    ThresholdSubscription sub;
+    sub.id = m_nextSubscriptionId++;
+    sub.low = low;
+    sub.high = high;
+    sub.percentile = percentile;
+    sub.above = false;
+    sub.callback = callback;
+    m_subscriptions[interface].push_back(sub);
+    return sub.id;
+}
+
+bool PathMetricsMonitor::UpdateThreshold(uint32_t subscriptionId, double percentile, double low, double high) {
+    for (auto& interfaceSubs : m_subscriptions) {
+        for (ThresholdSubscription& sub : interfaceSubs.second) {
+            if (sub.id == subscriptionId && sub.percentile == percentile) {
+                sub.low = low;
+                sub.high = high;
+                sub.above = false;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PathMetricsMonitor::CheckThresholds(uint32_t interface, const PathMetrics& metrics,
+                                         std::vector<ThresholdSubscription>& subs) {
+    for (ThresholdSubscription& sub : subs) {
+        double value;
+        if (sub.percentile > 0.0) {
+            if (metrics.packetsReceived % QUANTILE_CHECK_PERIOD != 0) continue;
+            value = GetInterfaceLatencyPercentile(interface, sub.percentile);
+        } else {
+            value = metrics.latency;
+        }
+        
+        if (!sub.above && value > sub.high) {
+            sub.above = true;
+            sub.callback(sub.id, true);
+        } else if (sub.above && value < sub.low) {
+            sub.above = false;
+            sub.callback(sub.id, false);
+        }
+    }
+}
+
+uint64_t PathMetricsMonitor::FlowOf(Ptr<const Packet> packet) {
+    Ipv4Header header;
+    if (packet->PeekHeader(header) == 0) {
+        return 0;
+    }
+    PacketFields fields;
+    ParseFields(header, packet, fields, header.GetSerializedSize());
+    return HashFlow(fields);
+}
+
+PathMetrics& PathMetricsMonitor::MetricsFor(uint32_t interface) {
+    if (interface >= m_interfaceMetrics.size()) {
+        m_interfaceMetrics.resize(interface + 1);
+    }
+    return m_interfaceMetrics[interface];
+}
+
+void PathMetricsMonitor::RecordTx(Ptr<const Packet> packet, uint32_t interface) {
+    PathMetrics& metrics = MetricsFor(interface);
+    metrics.packetsSent++;
+    metrics.txBytes += packet->GetSize();
+    
+    if (m_txTable.empty()) {
+        uint32_t size = 1;
+        while (size < m_txTableSize) {
+            size <<= 1;
+        }
+        m_txTable.resize(size);
+    }
+    
+    uint64_t uid = packet->GetUid();
+    TxRecord& record = m_txTable[uid & (m_txTable.size() - 1)];
+    record.uid = uid;
+    record.txTime = Simulator::Now();
+    record.interface = interface;
+    record.valid = true;
+}
+
+bool PathMetricsMonitor::LookupTx(uint64_t uid, Time& txTime, uint32_t& interface) {
+    if (m_txTable.empty()) return false;
+    
+    TxRecord& record = m_txTable[uid & (m_txTable.size() - 1)];
+    if (!record.valid || record.uid != uid) return false;
+    
+    record.valid = false;
+    if (Simulator::Now() - record.txTime > m_txTableMaxAge) return false;
+    
+    txTime = record.txTime;
+    interface = record.interface;
+    return true;
+}
+
+void PathMetricsMonitor::ExpireStaleMetrics() {
+    Time now = Simulator::Now();
+    for (auto& entry : m_latencyHistory) {
+        uint32_t interface = entry.first;
+        LatencyWindow& window = entry.second;
+        PathMetrics& metrics = MetricsFor(interface);
+        if (window.count == 0 || now - metrics.lastUpdateTime <= m_staleAge) continue;
+        
+        NS_LOG_INFO("Interface " << interface << ": aucun échantillon depuis "
+                    << (now - metrics.lastUpdateTime).GetSeconds() << " s, métriques expirées");
+        window.Resize(m_latencyWindowSize);
+        window.ewma = 0.0;
+        window.ewmaValid = false;
+        metrics.latency = 0.0;
+        metrics.latencyEwma = 0.0;
+        m_sketches.erase(interface);
+        
+        auto subs = m_subscriptions.find(interface);
+        if (subs == m_subscriptions.end()) continue;
+        for (ThresholdSubscription& sub : subs->second) {
+            if (sub.above) {
+                sub.above = false;
+                sub.callback(sub.id, false);
+            }
+        }
+    }
+    m_staleEvent = Simulator::Schedule(m_staleAge / 2, &PathMetricsMonitor::ExpireStaleMetrics, this);
+}
+
+void PathMetricsMonitor::UpdateBandwidthMetrics() {
+    Time now = Simulator::Now();
+    double elapsed = (now - m_lastBandwidthSample).GetSeconds();
+    
+    if (elapsed > 0) {
+        for (PathMetrics& metrics : m_interfaceMetrics) {
+            uint64_t delta = metrics.txBytes - metrics.txBytesAtSample;
+            metrics.bandwidth = (delta * 8.0) / elapsed / 1e6; // Mbps
+            metrics.txBytesAtSample = metrics.txBytes;
+        }
+    }
+    m_lastBandwidthSample = now;
+    
+    // Replanifier
+    m_bandwidthEvent = Simulator::Schedule(m_bandwidthInterval,
+                                           &PathMetricsMonitor::UpdateBandwidthMetrics, this);
+}
+
+void PathMetricsMonitor::StartExport(MetricsExporter* exporter, Time interval) {
+    m_exporter = exporter;
+    m_exportInterval = interval;
+    m_exportEvent = Simulator::Schedule(m_exportInterval, &PathMetricsMonitor::ExportMetrics, this);
+}
+
+void PathMetricsMonitor::ExportMetrics() {
+    MetricsRecord record;
+    record.timeNs = Simulator::Now().GetNanoSeconds();
+    record.series = SERIES_PATH;
+    for (uint32_t i = 0; i < m_interfaceMetrics.size(); i++) {
+        const PathMetrics& metrics = m_interfaceMetrics[i];
+        record.id = i;
+        record.values[0] = metrics.latency;
+        record.values[1] = metrics.latencyEwma;
+        record.values[2] = GetInterfaceLatencyPercentile(i, 0.99);
+        record.values[3] = metrics.bandwidth;
+        record.values[4] = metrics.packetsSent;
+        record.values[5] = metrics.packetsReceived;
+        m_exporter->Append(record);
+    }
+    m_exportEvent = Simulator::Schedule(m_exportInterval, &PathMetricsMonitor::ExportMetrics, this);
+}
+
+PathMetrics PathMetricsMonitor::GetInterfaceMetrics(uint32_t interface) const {
+    if (interface < m_interfaceMetrics.size()) {
+        return m_interfaceMetrics[interface];
+    }
+    return PathMetrics();
+}
+
+void PathMetricsMonitor::SnapshotLatencies(std::vector<double>& latency) const {
+    latency.resize(m_interfaceMetrics.size());
+    for (uint32_t i = 0; i < m_interfaceMetrics.size(); i++) {
+        latency[i] = m_interfaceMetrics[i].latency;
+    }
+}
+
+double PathMetricsMonitor::GetInterfaceLatencyPercentile(uint32_t interface, double q) {
+    auto it = m_sketches.find(interface);
+    return (it != m_sketches.end()) ? it->second.delay.Quantile(q) / 1000.0 : 0.0;
+}
+
+double PathMetricsMonitor::GetInterfaceJitterPercentile(uint32_t interface, double q) {
+    auto it = m_sketches.find(interface);
+    return (it != m_sketches.end()) ? it->second.jitter.Quantile(q) / 1000.0 : 0.0;
+}
+
+void PathMetricsMonitor::SetLatencyWindow(uint32_t samples) {
+    m_latencyWindowSize = std::max<uint32_t>(samples, 1);
+    for (auto& entry : m_latencyHistory) {
+        entry.second.Resize(m_latencyWindowSize);
+    }
+}
+
+void PathMetricsMonitor::PrintMetrics() {
+    std::cout << "\n========== MÉTRIQUES DES CHEMINS ==========\n";
+    for (uint32_t i = 0; i < m_interfaceMetrics.size(); i++) {
+        const PathMetrics& metric = m_interfaceMetrics[i];
+        std::cout << "Interface " << i << ":\n";
+        std::cout << "  Latence: " << metric.latency << " ms"
+                  << " (EWMA: " << metric.latencyEwma << " ms)\n";
+        std::cout << "  Latence P50/P95/P99: "
+                  << GetInterfaceLatencyPercentile(i, 0.50) << " / "
+                  << GetInterfaceLatencyPercentile(i, 0.95) << " / "
+                  << GetInterfaceLatencyPercentile(i, 0.99) << " ms\n";
+        std::cout << "  Gigue P50/P95/P99: "
+                  << GetInterfaceJitterPercentile(i, 0.50) << " / "
+                  << GetInterfaceJitterPercentile(i, 0.95) << " / "
+                  << GetInterfaceJitterPercentile(i, 0.99) << " ms\n";
+        std::cout << "  Bande passante: " << metric.bandwidth << " Mbps\n";
+        std::cout << "  Paquets envoyés: " << metric.packetsSent << "\n";
+        std::cout << "  Paquets reçus: " << metric.packetsReceived << "\n";
+    }
+    std::cout << "==========================================\n\n";
+}
+
+// ========================================
+// CLASSE: PolicyBasedRouter
+// ========================================
+
+TypeId PolicyBasedRouter::GetTypeId() {
+    static TypeId tid = TypeId("PolicyBasedRouter")
+        .SetParent<Ipv4RoutingProtocol>()
+        .SetGroupName("Internet")
+        .AddConstructor<PolicyBasedRouter>()
+        .AddAttribute("FlowCacheSize",
+                      "Nombre d'entrées du cache de flux (arrondi à une puissance de 2)",
+                      UintegerValue(4096),
+                      MakeUintegerAccessor(&PolicyBasedRouter::m_flowCacheSize),
+                      MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("FlowIdleTimeout",
+                      "Inactivité au-delà de laquelle un flux quitte le cache",
+                      TimeValue(Seconds(30.0)),
+                      MakeTimeAccessor(&PolicyBasedRouter::m_flowIdleTimeout),
+                      MakeTimeChecker())
+        .AddAttribute("FlowletTimeout",
+                      "Silence après lequel un flux réparti peut changer de chemin",
+                      TimeValue(MilliSeconds(50)),
+                      MakeTimeAccessor(&PolicyBasedRouter::m_flowletTimeout),
+                      MakeTimeChecker())
+        .AddAttribute("MultipathInterval",
+                      "Période de mise à jour des poids multichemin",
+                      TimeValue(MilliSeconds(500)),
+                      MakeTimeAccessor(&PolicyBasedRouter::m_weightInterval),
+                      MakeTimeChecker(MilliSeconds(1)));
+    return tid;
+}
+
+PolicyBasedRouter::PolicyBasedRouter()
+    : m_portTable(DEFAULT_PORT_TABLE),
+      m_dscpTable(DEFAULT_DSCP_TABLE),
+      m_packetCount(0),
+      m_nodeId(0),
+      m_flowCacheSize(4096),
+      m_flowIdleTimeout(Seconds(30.0)),
+      m_pathEpoch(1),
+      m_flowletTimeout(MilliSeconds(50)),
+      m_weightInterval(MilliSeconds(500)),
+      m_flowletMoves(0) {
+    NS_LOG_FUNCTION(this);
+    m_classInterface.fill(0);
+    m_classMultipath.fill(false);
+}
+
+PolicyBasedRouter::~PolicyBasedRouter() {
+    NS_LOG_FUNCTION(this);
+}
+
+void PolicyBasedRouter::Install(Ptr<Node> node, int16_t priority) {
+    Ptr<Ipv4ListRouting> list =
+        DynamicCast<Ipv4ListRouting>(node->GetObject<Ipv4>()->GetRoutingProtocol());
+    NS_ABORT_MSG_IF(!list, "PolicyBasedRouter nécessite un Ipv4ListRouting");
+    list->AddRoutingProtocol(Ptr<PolicyBasedRouter>(this), priority);
+}
+
+void PolicyBasedRouter::AddSteeredIngress(uint32_t interface) {
+    if (interface >= m_steeredIngress.size()) {
+        m_steeredIngress.resize(interface + 1, false);
+    }
+    m_steeredIngress[interface] = true;
+}
+
+void PolicyBasedRouter::SetInterfaceGateway(uint32_t interface, Ipv4Address gateway) {
+    m_gateways[interface] = gateway;
+    RebuildRoutes();
+}
+
+TrafficClass PolicyBasedRouter::ClassifyTraffic(uint16_t srcPort, uint16_t dstPort, uint8_t dscp) {
+    // Priorité: port de destination, puis port source, puis DSCP.
+    // Trois lectures de tableau, sélection sans branchement.
+    uint8_t byDst = m_portTable[dstPort];
+    uint8_t bySrc = m_portTable[srcPort];
+    uint8_t byDscp = m_dscpTable[dscp & 0x3f];
+    uint8_t byPort = (byDst != UNCLASSIFIED) ? byDst : bySrc;
+    return TrafficClass((byPort != UNCLASSIFIED) ? byPort : byDscp);
+}
+
+uint32_t PolicyBasedRouter::ClassifyFlow(const PacketFields& fields, TrafficClass& tclass) {
+    if (!m_flowCache.IsConfigured()) {
+        m_flowCache.Configure(m_flowCacheSize, m_flowIdleTimeout);
+    }
+    
+    // Seul le premier paquet d'un flux parcourt les règles
+    Time now = Simulator::Now();
+    Time idle;
+    FlowCacheEntry* entry = m_flowCache.Lookup(fields, now, &idle);
+    if (entry) {
+        tclass = TrafficClass(entry->tclass);
+        // Nouvelle rafale d'un flux réparti : la précédente a quitté le
+        // réseau, elle peut suivre les poids courants sans réordonnancement
+        if (m_classMultipath[tclass] && entry->pathEpoch != m_pathEpoch && idle > m_flowletTimeout) {
+            uint32_t path = SelectPath(fields);
+            entry->pathEpoch = m_pathEpoch;
+            if (path != 0 && path != entry->egressInterface) {
+                entry->egressInterface = path;
+                m_flowletMoves++;
+            }
+        }
+        return entry->egressInterface;
+    }
+    
+    tclass = ClassifyTraffic(fields.srcPort, fields.dstPort, fields.tos >> 2);
+    uint32_t egress = m_classInterface[tclass];
+    if (m_classMultipath[tclass]) {
+        uint32_t path = SelectPath(fields);
+        egress = (path != 0) ? path : egress;
+    }
+    m_flowCache.Insert(fields, tclass, egress, now)->pathEpoch = m_pathEpoch;
+    return egress;
+}
+
+Ptr<Ipv4Route> PolicyBasedRouter::RouteOutput(Ptr<Packet> p, const Ipv4Header& header,
+                                              Ptr<NetDevice> oif, Socket::SocketErrno& sockerr) {
+    // Le trafic local du routeur suit le routage de priorité inférieure
+    sockerr = Socket::ERROR_NOROUTETOHOST;
+    return nullptr;
+}
+
+bool PolicyBasedRouter::RouteInput(Ptr<const Packet> p, const Ipv4Header& header,
+                                   Ptr<const NetDevice> idev, const UnicastForwardCallback& ucb,
+                                   const MulticastForwardCallback& mcb, const LocalDeliverCallback& lcb,
+                                   const ErrorCallback& ecb) {
+    PERF_SCOPE("PolicyBasedRouter::RouteInput");
+    uint32_t iif = m_ipv4->GetInterfaceForDevice(idev);
+    if (iif >= m_steeredIngress.size() || !m_steeredIngress[iif]) {
+        return false;
+    }
+    if (header.GetDestination().IsMulticast() || header.GetDestination().IsBroadcast()) {
+        return false;
+    }
+    
+    m_packetCount++;
+    PacketFields fields;
+    ParseFields(header, p, fields);
+    
+    TrafficClass tclass;
+    uint32_t egress = ClassifyFlow(fields, tclass);
+    
+    EVENT_LOG(EVLOG_PBR, EVT_PBR_CLASSIFY, m_nodeId, tclass, fields.dstPort, egress);
+    
+    if (egress == 0 || egress == iif || egress >= m_interfaceRoutes.size() ||
+        !m_interfaceRoutes[egress]) {
+        return false;
+    }
+    
+    ucb(m_interfaceRoutes[egress], p, header);
+    return true;
+}
+
+void PolicyBasedRouter::SetIpv4(Ptr<Ipv4> ipv4) {
+    m_ipv4 = ipv4;
+    Ptr<Node> node = ipv4->GetObject<Node>();
+    m_nodeId = node ? node->GetId() : 0;
+    RebuildRoutes();
+}
+
+void PolicyBasedRouter::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const {
+    std::ostream* os = stream->GetStream();
+    *os << "Node: " << m_ipv4->GetObject<Node>()->GetId()
+        << ", Time: " << Now().As(unit)
+        << ", PolicyBasedRouter\n";
+    *os << "Classe   Interface  Passerelle\n";
+    for (uint32_t c = 0; c < NUM_TRAFFIC_CLASSES; c++) {
+        if (m_classMultipath[c] && !m_pathInterfaces.empty()) {
+            *os << c << "        multichemin";
+            for (uint32_t i = 0; i < m_pathInterfaces.size(); i++) {
+                *os << " " << m_pathInterfaces[i] << "(" << m_pathWeights[i] << ")";
+            }
+            *os << "\n";
+            continue;
+        }
+        uint32_t interface = m_classInterface[c];
+        *os << c << "        " << interface << "          ";
+        if (interface < m_interfaceRoutes.size() && m_interfaceRoutes[interface]) {
+            *os << m_interfaceRoutes[interface]->GetGateway();
+        } else {
+            *os << "-";
+        }
+        *os << "\n";
+    }
+}
+
+void PolicyBasedRouter::UpdateClassInterface(TrafficClass tclass, uint32_t interface) {
+    m_classInterface[tclass] = interface;
+    // Seuls les flux de cette classe seront reclassifiés
+    m_flowCache.InvalidateClass(tclass);
+    NS_LOG_INFO("Interface mise à jour pour classe " << tclass << " -> " << interface);
+}
+
+void PolicyBasedRouter::PrintFlowCacheStats() {
+    uint64_t lookups = m_flowCache.GetHits() + m_flowCache.GetMisses();
+    std::cout << "\n========== CACHE DE FLUX PBR ==========\n";
+    std::cout << "  Succès: " << m_flowCache.GetHits() << "\n";
+    std::cout << "  Défauts: " << m_flowCache.GetMisses() << "\n";
+    std::cout << "  Évictions: " << m_flowCache.GetEvictions() << "\n";
+    if (lookups > 0) {
+        std::cout << "  Taux de succès: " << (100.0 * m_flowCache.GetHits() / lookups) << " %\n";
+    }
+    std::cout << "=======================================\n";
+}
+
+void PolicyBasedRouter::AddMultipathInterface(uint32_t interface, double capacity) {
+    m_pathInterfaces.push_back(interface);
+    m_pathCapacity.push_back(capacity);
+    m_pathWeights.push_back(capacity);
+    m_pathFlows.push_back(0);
+    m_pathEpoch++;
+}
+
+void PolicyBasedRouter::SetClassMultipath(TrafficClass tclass, bool enable) {
+    m_classMultipath[tclass] = enable;
+    m_flowCache.InvalidateClass(tclass);
+}
+
+void PolicyBasedRouter::EnableMultipath(Ptr<PathMetricsMonitor> monitor) {
+    m_pathMonitor = monitor;
+    m_weightEvent.Cancel();
+    UpdateMultipathWeights();
+}
+
+double PolicyBasedRouter::ResolvePathCapacity(uint32_t path) {
+    if (m_pathCapacity[path] <= 0.0 && m_ipv4) {
+        DataRateValue rate;
+        Ptr<NetDevice> device = m_ipv4->GetNetDevice(m_pathInterfaces[path]);
+        if (device->GetAttributeFailSafe("DataRate", rate)) {
+            m_pathCapacity[path] = rate.Get().GetBitRate() / 1e6;
+        }
+    }
+    return m_pathCapacity[path];
+}
+
+void PolicyBasedRouter::UpdateMultipathWeights() {
+    // Poids = bande passante libre, réduite en proportion de l'excès de
+    // latence sur le meilleur chemin ; lissé pour ne pas osciller avec la
+    // charge que la répartition déplace elle-même
+    double minLatency = 0.0;
+    if (m_pathMonitor) {
+        for (uint32_t interface : m_pathInterfaces) {
+            double latency = m_pathMonitor->GetInterfaceLatency(interface);
+            if (latency > 0.0 && (minLatency == 0.0 || latency < minLatency)) {
+                minLatency = latency;
+            }
+        }
+    }
+    
+    for (uint32_t i = 0; i < m_pathInterfaces.size(); i++) {
+        uint32_t interface = m_pathInterfaces[i];
+        double capacity = ResolvePathCapacity(i);
+        double target = capacity;
+        if (m_pathMonitor) {
+            double used = m_pathMonitor->GetInterfaceBandwidth(interface);
+            double latency = m_pathMonitor->GetInterfaceLatency(interface);
+            target = std::max(capacity - used, capacity * MIN_PATH_SHARE);
+            if (latency > 0.0 && minLatency > 0.0) {
+                target *= minLatency / latency;
+            }
+        }
+        bool usable = !m_ipv4 || (interface < m_interfaceRoutes.size() && m_interfaceRoutes[interface]);
+        if (!usable) {
+            m_pathWeights[i] = 0.0;
+        } else if (m_pathWeights[i] <= 0.0) {
+            m_pathWeights[i] = target;
+        } else {
+            m_pathWeights[i] += WEIGHT_SMOOTHING * (target - m_pathWeights[i]);
+        }
+        NS_LOG_LOGIC("Poids multichemin interface " << interface << ": " << m_pathWeights[i]);
+    }
+    m_pathEpoch++;
+    
+    if (m_pathMonitor) {
+        m_weightEvent = Simulator::Schedule(m_weightInterval,
+                                            &PolicyBasedRouter::UpdateMultipathWeights, this);
+    }
+}
+
+uint32_t PolicyBasedRouter::SelectPath(const PacketFields& fields) {
+    // Hachage de rendez-vous pondéré : score = -ln(u) / poids, u uniforme
+    // tiré du 5-tuple et de l'interface ; le plus petit score l'emporte avec
+    // une probabilité proportionnelle au poids. Un changement de poids ne
+    // déplace que les flux dont le gagnant change.
+    uint64_t key = HashFlow(fields);
+    uint32_t best = m_pathInterfaces.size();
+    double bestScore = 0.0;
+    for (uint32_t i = 0; i < m_pathInterfaces.size(); i++) {
+        if (m_pathWeights[i] <= 0.0) continue;
+        uint64_t h = key ^ (uint64_t(m_pathInterfaces[i]) * 0x9e3779b97f4a7c15ull);
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        double u = (double(h >> 11) + 0.5) * 0x1p-53;
+        double score = -std::log(u) / m_pathWeights[i];
+        if (best == m_pathInterfaces.size() || score < bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    if (best == m_pathInterfaces.size()) {
+        return 0;
+    }
+    m_pathFlows[best]++;
+    return m_pathInterfaces[best];
+}
+
+void PolicyBasedRouter::PrintMultipathStats() {
+    if (m_pathInterfaces.empty()) return;
+    std::cout << "\n========== MULTICHEMIN PBR ==========\n";
+    for (uint32_t i = 0; i < m_pathInterfaces.size(); i++) {
+        std::cout << "  Interface " << m_pathInterfaces[i] << ": poids " << m_pathWeights[i]
+                  << ", capacité " << m_pathCapacity[i] << " Mbps, flux/flowlets "
+                  << m_pathFlows[i] << "\n";
+    }
+    std::cout << "  Flowlets déplacées: " << m_flowletMoves << "\n";
+    std::cout << "=====================================\n";
+}
+
+void PolicyBasedRouter::DoDispose() {
+    m_weightEvent.Cancel();
+    m_pathMonitor = nullptr;
+    m_ipv4 = nullptr;
+    m_interfaceRoutes.clear();
+    Ipv4RoutingProtocol::DoDispose();
+}
+
+Ipv4Address PolicyBasedRouter::DiscoverPeerAddress(uint32_t interface) const {
+    Ptr<NetDevice> device = m_ipv4->GetNetDevice(interface);
+    Ptr<Channel> channel = device->GetChannel();
+    if (!channel) return Ipv4Address::GetAny();
+    
+    for (std::size_t i = 0; i < channel->GetNDevices(); i++) {
+        Ptr<NetDevice> peer = channel->GetDevice(i);
+        if (peer == device) continue;
+        Ptr<Ipv4> peerIpv4 = peer->GetNode()->GetObject<Ipv4>();
+        if (!peerIpv4) continue;
+        int32_t peerInterface = peerIpv4->GetInterfaceForDevice(peer);
+        if (peerInterface >= 0 && peerIpv4->GetNAddresses(peerInterface) > 0) {
+            return peerIpv4->GetAddress(peerInterface, 0).GetLocal();
+        }
+    }
+    return Ipv4Address::GetAny();
+}
+
+void PolicyBasedRouter::RebuildRoutes() {
+    m_interfaceRoutes.clear();
+    if (!m_ipv4) return;
+    
+    m_interfaceRoutes.resize(m_ipv4->GetNInterfaces());
+    for (uint32_t i = 1; i < m_ipv4->GetNInterfaces(); i++) {
+        if (!m_ipv4->IsUp(i) || m_ipv4->GetNAddresses(i) == 0) continue;
+        
+        auto it = m_gateways.find(i);
+        Ipv4Address gateway = (it != m_gateways.end()) ? it->second : DiscoverPeerAddress(i);
+        if (gateway == Ipv4Address::GetAny()) continue;
+        
+        Ptr<Ipv4Route> route = Create<Ipv4Route>();
+        route->SetDestination(gateway);
+        route->SetGateway(gateway);
+        route->SetSource(m_ipv4->GetAddress(i, 0).GetLocal());
+        route->SetOutputDevice(m_ipv4->GetNetDevice(i));
+        m_interfaceRoutes[i] = route;
+    }
+}
+
+// ========================================
+// CLASSE: SdwanController
+// ========================================
+
+TypeId SdwanController::GetTypeId() {
+    static TypeId tid = TypeId("SdwanController")
+        .SetParent<Object>()
+        .SetGroupName("Applications")
+        .AddAttribute("EvaluationInterval",
+                      "Période d'évaluation des politiques en mode périodique",
+                      TimeValue(Seconds(1.0)),
+                      MakeTimeAccessor(&SdwanController::m_evaluationInterval),
+                      MakeTimeChecker())
+        .AddAttribute("EventDriven",
+                      "Évaluer une politique uniquement quand une métrique franchit son seuil",
+                      BooleanValue(false),
+                      MakeBooleanAccessor(&SdwanController::m_eventDriven),
+                      MakeBooleanChecker())
+        .AddAttribute("HoldDown",
+                      "Délai minimal entre deux basculements d'une même politique",
+                      TimeValue(Seconds(2.0)),
+                      MakeTimeAccessor(&SdwanController::m_holdDown),
+                      MakeTimeChecker())
+        .AddAttribute("RestoreRatio",
+                      "Fraction du seuil sous laquelle le chemin primaire est considéré restauré",
+                      DoubleValue(0.7),
+                      MakeDoubleAccessor(&SdwanController::m_restoreRatio),
+                      MakeDoubleChecker<double>(0.0, 1.0))
+        .AddTraceSource("Switch",
+                        "Basculement d'une classe de trafic (classe, nouvelle interface)",
+                        MakeTraceSourceAccessor(&SdwanController::m_switchTrace),
+                        "ns3::TracedCallback::Uint32Uint32");
+    return tid;
+}
+
+SdwanController::SdwanController()
+    : m_maxInterface(0),
+      m_evaluationInterval(Seconds(1.0)),
+      m_eventDriven(false),
+      m_holdDown(Seconds(2.0)),
+      m_restoreRatio(0.7),
+      m_switchCount(0) {
+    NS_LOG_FUNCTION(this);
+    // Slot 0 réservé aux politiques sans seuil de queue
+    m_tailInterface.push_back(0);
+    m_tailQuantile.push_back(0.0);
+    m_tailSnapshot.push_back(0.0);
+}
+
+SdwanController::~SdwanController() {
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t SdwanController::AddPolicy(TrafficClass tclass, double latencyThresh, 
+                                    uint32_t primaryIf, uint32_t secondaryIf) {
+    PolicyRule rule;
+    rule.latencyThreshold = latencyThresh;
+    rule.bandwidthThreshold = 5.0; // Mbps
+    rule.tailPercentile = 0.99;
+    rule.tailLatencyThreshold = 0.0;
+    rule.primaryInterface = primaryIf;
+    rule.secondaryInterface = secondaryIf;
+    rule.currentInterface = primaryIf;
+    rule.holdUntil = Seconds(0);
+    uint32_t id = m_policies.Add(tclass, rule);
+    m_maxInterface = std::max(m_maxInterface, std::max(primaryIf, secondaryIf));
+    
+    if (m_pbr) {
+        m_pbr->UpdateClassInterface(tclass, primaryIf);
+    }
+    
+    NS_LOG_INFO("Politique " << id << " ajoutée pour classe " << tclass << 
+               " | Seuil latence: " << latencyThresh << " ms");
+    return id;
+}
+
+void SdwanController::SetTailLatencyThreshold(uint32_t policyId, double percentile, double thresholdMs) {
+    if (policyId >= m_policies.Size()) return;
+    m_policies.tailPercentile[policyId] = percentile;
+    m_policies.tailLatencyThreshold[policyId] = thresholdMs;
+    m_policies.tailSlot[policyId] = (thresholdMs > 0.0) ?
+        TailSlotFor(m_policies.primaryInterface[policyId], percentile) : 0;
+    
+    NS_LOG_INFO("Seuil de queue pour politique " << policyId << " | P" << percentile * 100
+                << " < " << thresholdMs << " ms");
+}
+
+void SdwanController::SetLatencyThreshold(uint32_t policyId, double thresholdMs) {
+    if (policyId >= m_policies.Size()) return;
+    m_policies.latencyThreshold[policyId] = thresholdMs;
+    
+    // Mode événementiel démarré : la bande de l'abonnement suit le seuil
+    for (uint32_t sid = 0; sid < m_subscriptionPolicy.size(); sid++) {
+        if (m_subscriptionPolicy[sid] == policyId &&
+            m_monitor->UpdateThreshold(sid, 0.0, thresholdMs * m_restoreRatio, thresholdMs)) {
+            OnThresholdCrossing(sid, false);
+        }
+    }
+    NS_LOG_INFO("Seuil de latence pour politique " << policyId << " -> " << thresholdMs << " ms");
+}
+
+void SdwanController::Start() {
+    NS_LOG_FUNCTION(this);
+    if (!m_eventDriven) {
+        m_periodicEvent = Simulator::Schedule(m_evaluationInterval, 
+                                             &SdwanController::PeriodicPolicyEvaluation, this);
+        return;
+    }
+    
+    // Mode événementiel : aucun réveil tant que les chemins restent dans leur bande
+    Callback<void, uint32_t, bool> cb =
+        MakeCallback(&SdwanController::OnThresholdCrossing, this);
+    for (uint32_t id = 0; id < m_policies.Size(); id++) {
+        uint32_t primaryIf = m_policies.primaryInterface[id];
+        double threshold = m_policies.latencyThreshold[id];
+        MapSubscription(m_monitor->SubscribeThreshold(primaryIf, threshold * m_restoreRatio,
+                                                      threshold, 0.0, cb), id);
+        
+        double tailThreshold = m_policies.tailLatencyThreshold[id];
+        if (tailThreshold > 0.0) {
+            MapSubscription(m_monitor->SubscribeThreshold(primaryIf,
+                                                          tailThreshold * m_restoreRatio,
+                                                          tailThreshold,
+                                                          m_policies.tailPercentile[id], cb), id);
+        }
+    }
+}
+
+void SdwanController::Stop() {
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_periodicEvent);
+    for (EventId& pending : m_policies.pendingEvaluation) {
+        Simulator::Cancel(pending);
+    }
+}
+
+void SdwanController::PeriodicPolicyEvaluation() {
+    NS_LOG_FUNCTION(this);
+    PERF_SCOPE("SdwanController::PeriodicPolicyEvaluation");
+    
+    EvaluateAll();
+    
+    // Afficher les métriques périodiquement
+    if (((int)Simulator::Now().GetSeconds()) % 5 == 0) {
+        m_monitor->PrintMetrics();
+    }
+    
+    // Replanifier
+    m_periodicEvent = Simulator::Schedule(m_evaluationInterval,
+                                         &SdwanController::PeriodicPolicyEvaluation, this);
+}
+
+void SdwanController::EvaluateAll() {
+    TakeSnapshot();
+    
+    uint32_t n = m_policies.Size();
+    m_decisions.resize(n);
+    const double* latency = m_latencySnapshot.data();
+    const double* tail = m_tailSnapshot.data();
+    int64_t now = Simulator::Now().GetTimeStep();
+    uint8_t* decisions = m_decisions.data();
+    for (uint32_t i = 0; i < n; i++) {
+        decisions[i] = Decide(i, latency, tail, now);
+    }
+    
+    for (uint32_t i = 0; i < n; i++) {
+        if (decisions[i] & (DECISION_SWITCH | DECISION_RESTORE)) {
+            ApplyDecision(i, decisions[i]);
+        }
+    }
+}
+
+const char* SdwanController::ClassName(TrafficClass tclass) {
+    switch (tclass) {
+        case VIDEO_TRAFFIC: return "Flow_Video";
+        case DATA_TRAFFIC: return "Flow_Data";
+        default: return "Flow_Default";
+    }
+}
+
+uint32_t SdwanController::TailSlotFor(uint32_t interface, double percentile) {
+    for (uint32_t slot = 1; slot < m_tailInterface.size(); slot++) {
+        if (m_tailInterface[slot] == interface && m_tailQuantile[slot] == percentile) {
+            return slot;
+        }
+    }
+    m_tailInterface.push_back(interface);
+    m_tailQuantile.push_back(percentile);
+    m_tailSnapshot.push_back(0.0);
+    return m_tailInterface.size() - 1;
+}
+
+void SdwanController::MapSubscription(uint32_t subscriptionId, uint32_t policyId) {
+    if (subscriptionId >= m_subscriptionPolicy.size()) {
+        m_subscriptionPolicy.resize(subscriptionId + 1, uint32_t(NO_POLICY));
+    }
+    m_subscriptionPolicy[subscriptionId] = policyId;
+}
+
+void SdwanController::SnapshotLatencies() {
+    m_monitor->SnapshotLatencies(m_latencySnapshot);
+    if (m_latencySnapshot.size() <= m_maxInterface) {
+        m_latencySnapshot.resize(m_maxInterface + 1, 0.0);
+    }
+}
+
+void SdwanController::TakeSnapshot() {
+    SnapshotLatencies();
+    for (uint32_t slot = 1; slot < m_tailSnapshot.size(); slot++) {
+        m_tailSnapshot[slot] = m_monitor->GetInterfaceLatencyPercentile(m_tailInterface[slot],
+                                                                        m_tailQuantile[slot]);
+    }
+}
+
+uint8_t SdwanController::Decide(uint32_t i, const double* latency, const double* tail, int64_t now) const {
+    uint32_t primaryIf = m_policies.primaryInterface[i];
+    uint32_t current = m_policies.currentInterface[i];
+    double primaryLatency = latency[primaryIf];
+    double secondaryLatency = latency[m_policies.secondaryInterface[i]];
+    double threshold = m_policies.latencyThreshold[i];
+    double tailThreshold = m_policies.tailLatencyThreshold[i];
+    double primaryTail = tail[m_policies.tailSlot[i]];
+    
+    bool tailEnabled = tailThreshold > 0.0;
+    bool degraded = (primaryLatency > threshold) | (tailEnabled & (primaryTail > tailThreshold));
+    bool restored = (primaryLatency < threshold * m_restoreRatio) &
+                    (!tailEnabled | (primaryTail < tailThreshold * m_restoreRatio));
+    bool onPrimary = current == primaryIf;
+    bool onSecondary = !onPrimary & (current == m_policies.secondaryInterface[i]);
+    bool released = now >= m_policies.holdUntil[i];
+    
+    bool toSecondary = released & onPrimary & degraded & (secondaryLatency < primaryLatency * 0.8);
+    bool toPrimary = released & onSecondary & restored;
+    return uint8_t(toSecondary) | (uint8_t(toPrimary) << 1) | (uint8_t(degraded) << 2);
+}
+
+void SdwanController::ApplyDecision(uint32_t id, uint8_t decision) {
+    TrafficClass tclass = TrafficClass(m_policies.trafficClass[id]);
+    double primaryLatency = m_latencySnapshot[m_policies.primaryInterface[id]];
+    uint32_t newInterface;
+    
+    uint32_t node = m_router ? m_router->GetId() : 0;
+    // Journal ouvert : l'évènement remplace la bannière console
+    bool banner = !EventLog::Get().IsOpen();
+    
+    if (banner) std::cout << "[" << Simulator::Now().GetSeconds() << "s] ";
+    if (decision & DECISION_SWITCH) {
+        newInterface = m_policies.secondaryInterface[id];
+        double primaryTail = m_tailSnapshot[m_policies.tailSlot[id]];
+        double tailThreshold = m_policies.tailLatencyThreshold[id];
+        if (banner) std::cout << "⚠️  BASCULEMENT: " << ClassName(tclass) << " vers lien secondaire\n";
+        if (tailThreshold > 0.0 && primaryTail > tailThreshold) {
+            EVENT_LOG(EVLOG_SDWAN, EVT_SDWAN_TAIL_SWITCH, node, tclass, newInterface,
+                      EventLogDouble(primaryTail), EventLogDouble(tailThreshold),
+                      EventLogDouble(m_policies.tailPercentile[id]));
+            if (banner) {
+                std::cout << "    Raison: Latence P" << m_policies.tailPercentile[id] * 100
+                         << " primaire (" << primaryTail << "ms) > seuil ("
+                         << tailThreshold << "ms)\n";
+            }
+        } else {
+            EVENT_LOG(EVLOG_SDWAN, EVT_SDWAN_SWITCH, node, tclass, newInterface,
+                      EventLogDouble(primaryLatency),
+                      EventLogDouble(m_policies.latencyThreshold[id]));
+            if (banner) {
+                std::cout << "    Raison: Latence primaire (" << primaryLatency 
+                         << "ms) > seuil (" << m_policies.latencyThreshold[id] << "ms)\n";
+            }
+        }
+    } else {
+        newInterface = m_policies.primaryInterface[id];
+        EVENT_LOG(EVLOG_SDWAN, EVT_SDWAN_RESTORE, node, tclass, newInterface,
+                  EventLogDouble(primaryLatency));
+        if (banner) {
+            std::cout << "✓ RETOUR: " << ClassName(tclass) << " vers lien primaire\n";
+            std::cout << "    Raison: Latence primaire restaurée (" 
+                     << primaryLatency << "ms)\n";
+        }
+    }
+    
+    m_policies.currentInterface[id] = newInterface;
+    m_policies.holdUntil[id] = (Simulator::Now() + m_holdDown).GetTimeStep();
+    m_pbr->UpdateClassInterface(tclass, newInterface);
+    m_switchCount++;
+    PERF_COUNT("SdwanController::switches", 1);
+    m_switchTrace(tclass, newInterface);
+}
+
+void SdwanController::OnThresholdCrossing(uint32_t subscriptionId, bool above) {
+    if (subscriptionId >= m_subscriptionPolicy.size()) return;
+    uint32_t id = m_subscriptionPolicy[subscriptionId];
+    if (id == NO_POLICY) return;
+    
+    EventId& pending = m_policies.pendingEvaluation[id];
+    if (pending.IsPending()) return;
+    
+    // Pendant le hold-down, on diffère l'évaluation à son expiration
+    Time now = Simulator::Now();
+    Time holdUntil = TimeStep(m_policies.holdUntil[id]);
+    if (now < holdUntil) {
+        pending = Simulator::Schedule(holdUntil - now,
+                                      &SdwanController::DeferredEvaluation, this, id);
+        return;
+    }
+    EvaluatePolicy(id);
+}
+
+void SdwanController::EvaluatePolicy(uint32_t id) {
+    PERF_SCOPE("SdwanController::EvaluatePolicy");
+    SnapshotLatencies();
+    uint32_t slot = m_policies.tailSlot[id];
+    if (slot != 0) {
+        m_tailSnapshot[slot] = m_monitor->GetInterfaceLatencyPercentile(m_tailInterface[slot],
+                                                                        m_tailQuantile[slot]);
+    }
+    
+    uint8_t decision = Decide(id, m_latencySnapshot.data(), m_tailSnapshot.data(),
+                              Simulator::Now().GetTimeStep());
+    bool switched = decision & (DECISION_SWITCH | DECISION_RESTORE);
+    if (switched) {
+        ApplyDecision(id, decision);
+    }
+    
+    // En mode événementiel, un primaire encore dégradé sans basculement
+    // possible (secondaire pas meilleur) est revérifié après le hold-down
+    EventId& pending = m_policies.pendingEvaluation[id];
+    if (m_eventDriven && !switched && (decision & DECISION_DEGRADED) &&
+        m_policies.currentInterface[id] == m_policies.primaryInterface[id] &&
+        !pending.IsPending()) {
+        pending = Simulator::Schedule(m_holdDown, &SdwanController::DeferredEvaluation, this, id);
+    }
+}
+
+} // namespace ns3
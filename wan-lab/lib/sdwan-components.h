@@ -0,0 +1,1001 @@
+/*
+ * Composants PBR / SD-WAN de l'exercice 5, partagés par les scénarios de
+ * wan-lab via la bibliothèque scratch-wan-lab-lib :
+ * - PathMetricsMonitor : latence, gigue et débit par interface de sortie
+ * - PolicyBasedRouter : classification et orientation des flux par classe
+ * - SdwanController : politiques de basculement sur seuils de latence
+ *
+ * Les méthodes des chemins chauds de petite taille (cache de flux,
+ * esquisses, accesseurs) restent en ligne ici ; le reste est compilé une
+ * seule fois dans sdwan-components.cc.
+ */
+
+#ifndef SDWAN_COMPONENTS_H
+#define SDWAN_COMPONENTS_H
+
+#include "metrics-exporter.h"
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+// ========================================
+// ÉNUMÉRATIONS ET STRUCTURES
+// ========================================
+
+enum TrafficClass {
+    VIDEO_TRAFFIC,
+    DATA_TRAFFIC,
+    DEFAULT_TRAFFIC,
+    NUM_TRAFFIC_CLASSES
+};
+
+struct PolicyRule {
+    double latencyThreshold;        // ms
+    double bandwidthThreshold;      // Mbps
+    double tailPercentile;          // Quantile surveillé (ex: 0.99)
+    double tailLatencyThreshold;    // ms, 0 = pas de seuil sur la queue
+    uint32_t primaryInterface;
+    uint32_t secondaryInterface;
+    uint32_t currentInterface;
+    Time holdUntil;                 // Aucun basculement avant cet instant
+    EventId pendingEvaluation;      // Réévaluation différée (hold-down)
+};
+
+// Table des politiques en structure de tableaux : une colonne par champ de
+// PolicyRule, une ligne par identifiant dense. L'évaluation par lot lit les
+// colonnes séquentiellement ; les instants de hold-down sont stockés en
+// pas de temps bruts pour que la comparaison reste un simple entier.
+struct PolicyTable {
+    std::vector<uint8_t> trafficClass;
+    std::vector<double> latencyThreshold;
+    std::vector<double> bandwidthThreshold;
+    std::vector<double> tailPercentile;
+    std::vector<double> tailLatencyThreshold;
+    std::vector<uint32_t> tailSlot;             // Index dans le cliché des quantiles
+    std::vector<uint32_t> primaryInterface;
+    std::vector<uint32_t> secondaryInterface;
+    std::vector<uint32_t> currentInterface;
+    std::vector<int64_t> holdUntil;             // Time::GetTimeStep()
+    std::vector<EventId> pendingEvaluation;
+    
+    uint32_t Size() const {
+        return trafficClass.size();
+    }
+    
+    void Reserve(uint32_t n) {
+        trafficClass.reserve(n);
+        latencyThreshold.reserve(n);
+        bandwidthThreshold.reserve(n);
+        tailPercentile.reserve(n);
+        tailLatencyThreshold.reserve(n);
+        tailSlot.reserve(n);
+        primaryInterface.reserve(n);
+        secondaryInterface.reserve(n);
+        currentInterface.reserve(n);
+        holdUntil.reserve(n);
+        pendingEvaluation.reserve(n);
+    }
+    
+    uint32_t Add(TrafficClass tclass, const PolicyRule& rule) {
+        trafficClass.push_back(tclass);
+        latencyThreshold.push_back(rule.latencyThreshold);
+        bandwidthThreshold.push_back(rule.bandwidthThreshold);
+        tailPercentile.push_back(rule.tailPercentile);
+        tailLatencyThreshold.push_back(rule.tailLatencyThreshold);
+        tailSlot.push_back(0);
+        primaryInterface.push_back(rule.primaryInterface);
+        secondaryInterface.push_back(rule.secondaryInterface);
+        currentInterface.push_back(rule.currentInterface);
+        holdUntil.push_back(rule.holdUntil.GetTimeStep());
+        pendingEvaluation.push_back(rule.pendingEvaluation);
+        return trafficClass.size() - 1;
+    }
+    
+    // Vue ligne d'une politique (copie)
+    PolicyRule Get(uint32_t id) const {
+        PolicyRule rule;
+        rule.latencyThreshold = latencyThreshold[id];
+        rule.bandwidthThreshold = bandwidthThreshold[id];
+        rule.tailPercentile = tailPercentile[id];
+        rule.tailLatencyThreshold = tailLatencyThreshold[id];
+        rule.primaryInterface = primaryInterface[id];
+        rule.secondaryInterface = secondaryInterface[id];
+        rule.currentInterface = currentInterface[id];
+        rule.holdUntil = TimeStep(holdUntil[id]);
+        rule.pendingEvaluation = pendingEvaluation[id];
+        return rule;
+    }
+};
+
+// Abonnement à un franchissement de seuil sur une interface. La bande
+// [low, high] fournit l'hystérésis : l'état « au-dessus » n'est quitté
+// qu'une fois la métrique repassée sous low.
+struct ThresholdSubscription {
+    uint32_t id;
+    double low;                     // ms
+    double high;                    // ms
+    double percentile;              // 0 = moyenne mobile, sinon quantile (ex: 0.99)
+    bool above;
+    Callback<void, uint32_t, bool> callback;    // (id, au-dessus du seuil)
+};
+
+struct PathMetrics {
+    double latency;                 // ms (moyenne mobile sur la fenêtre)
+    double latencyEwma;             // ms (moyenne exponentielle)
+    double bandwidth;               // Mbps (débit émis sur la dernière fenêtre)
+    uint32_t packetsSent;
+    uint32_t packetsReceived;
+    uint64_t txBytes;               // Octets émis depuis le début
+    uint64_t txBytesAtSample;       // Valeur de txBytes au dernier échantillon
+    Time lastUpdateTime;
+    
+    PathMetrics() : latency(0.0), latencyEwma(0.0), bandwidth(0.0),
+                    packetsSent(0), packetsReceived(0), txBytes(0), txBytesAtSample(0) {}
+};
+
+// Fenêtre glissante de latence à capacité fixe (tampon circulaire).
+// L'insertion et la moyenne sont en O(1) grâce à la somme courante ;
+// la somme est recalculée à chaque tour complet pour éviter la dérive
+// des arrondis flottants (coût amorti O(1)).
+struct LatencyWindow {
+    std::vector<double> samples;
+    uint32_t head;
+    uint32_t count;
+    double sum;
+    double ewma;
+    bool ewmaValid;
+
+    LatencyWindow() : head(0), count(0), sum(0.0), ewma(0.0), ewmaValid(false) {}
+
+    void Resize(uint32_t capacity) {
+        samples.assign(capacity > 0 ? capacity : 1, 0.0);
+        head = 0;
+        count = 0;
+        sum = 0.0;
+    }
+
+    void Push(double value, double alpha) {
+        uint32_t capacity = samples.size();
+        if (count == capacity) {
+            sum -= samples[head];
+        } else {
+            count++;
+        }
+        samples[head] = value;
+        sum += value;
+        head++;
+        if (head == capacity) {
+            head = 0;
+            if (count == capacity) {
+                sum = 0.0;
+                for (double v : samples) {
+                    sum += v;
+                }
+            }
+        }
+        ewma = ewmaValid ? alpha * value + (1.0 - alpha) * ewma : value;
+        ewmaValid = true;
+    }
+
+    double Mean() const {
+        return (count > 0) ? sum / count : 0.0;
+    }
+};
+
+// Histogramme log-linéaire (type HDR) en microsecondes : 2^SUB_BITS
+// sous-classes par puissance de deux : le milieu d'une classe est à moins de
+// 1/2^(SUB_BITS+1), soit ~1,6 %, de toute valeur de la classe, pour
+// une mémoire fixe et une insertion O(1). Deux époques alternent afin que
+// les quantiles reflètent la période récente et non toute la simulation.
+class QuantileSketch {
+public:
+    static const uint32_t SUB_BITS = 5;
+    static const uint32_t SUB_COUNT = 1u << SUB_BITS;
+    static const uint32_t BUCKETS = (32 - SUB_BITS + 1) * SUB_COUNT; // valeurs < 2^32 µs
+    
+private:
+    std::array<uint32_t, BUCKETS> m_counts[2];
+    uint64_t m_totals[2];
+    uint32_t m_current;
+    Time m_epochStart;
+    
+    static uint32_t BucketIndex(uint64_t value) {
+        if (value >= (1ull << 32)) {
+            value = (1ull << 32) - 1;
+        }
+        if (value < SUB_COUNT) {
+            return value;
+        }
+        uint32_t magnitude = 63 - __builtin_clzll(value) - SUB_BITS;
+        return magnitude * SUB_COUNT + (value >> magnitude);
+    }
+    
+    static double BucketMidpoint(uint32_t index) {
+        if (index < SUB_COUNT) {
+            return index;
+        }
+        uint32_t magnitude = index / SUB_COUNT - 1;
+        uint64_t low = uint64_t(index - magnitude * SUB_COUNT) << magnitude;
+        return low + ((1ull << magnitude) - 1) / 2.0;
+    }
+    
+public:
+    QuantileSketch() : m_current(0) {
+        Clear();
+    }
+    
+    void Clear() {
+        m_counts[0].fill(0);
+        m_counts[1].fill(0);
+        m_totals[0] = m_totals[1] = 0;
+        m_epochStart = Simulator::Now();
+    }
+    
+    void Insert(double valueUs, Time epoch) {
+        Time now = Simulator::Now();
+        if (now - m_epochStart >= epoch) {
+            // Plus d'une époque sans échantillon : on repart de zéro
+            if (now - m_epochStart >= epoch + epoch) {
+                Clear();
+            } else {
+                m_current ^= 1;
+                m_counts[m_current].fill(0);
+                m_totals[m_current] = 0;
+            }
+            m_epochStart = now;
+        }
+        m_counts[m_current][BucketIndex(valueUs > 0.0 ? uint64_t(valueUs) : 0)]++;
+        m_totals[m_current]++;
+    }
+    
+    uint64_t GetCount() const {
+        return m_totals[0] + m_totals[1];
+    }
+    
+    // Quantile q (0..1) en microsecondes, sur l'époque courante et la précédente
+    double Quantile(double q) const {
+        uint64_t total = GetCount();
+        if (total == 0) return 0.0;
+        
+        uint64_t rank = std::max<uint64_t>(1, std::ceil(q * total));
+        uint64_t cumulative = 0;
+        for (uint32_t i = 0; i < BUCKETS; i++) {
+            cumulative += m_counts[0][i] + m_counts[1][i];
+            if (cumulative >= rank) {
+                return BucketMidpoint(i);
+            }
+        }
+        return BucketMidpoint(BUCKETS - 1);
+    }
+};
+
+// Esquisses de délai et de gigue d'une interface. La gigue est la variation
+// instantanée |D(i) - D(i-1)| entre deux paquets consécutifs d'un même flux
+// (RFC 3550) : les flux qui partagent le chemin ne mélangent pas leurs délais.
+// Le dernier délai est gardé pour au plus MAX_FLOWS flux ; au-delà, la table
+// est vidée et chaque flux perd un échantillon de gigue.
+struct PathSketches {
+    static const uint32_t MAX_FLOWS = 4096;
+    
+    QuantileSketch delay;
+    QuantileSketch jitter;
+    std::unordered_map<uint64_t, double> lastDelayUs;   // Hachage du 5-tuple -> µs
+};
+
+// Tag transporté par le paquet : instant d'émission et interface de sortie
+// du routeur surveillé. Il est relu au point de réception, ce qui évite
+// de conserver un état par paquet côté moniteur.
+class TxTimestampTag : public Tag {
+private:
+    Time m_txTime;
+    uint32_t m_interface;
+    
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("TxTimestampTag")
+            .SetParent<Tag>()
+            .SetGroupName("Applications")
+            .AddConstructor<TxTimestampTag>();
+        return tid;
+    }
+    
+    TxTimestampTag() : m_interface(0) {}
+    TxTimestampTag(Time txTime, uint32_t interface) : m_txTime(txTime), m_interface(interface) {}
+    
+    virtual TypeId GetInstanceTypeId() const {
+        return GetTypeId();
+    }
+    
+    virtual uint32_t GetSerializedSize() const {
+        return 12;
+    }
+    
+    virtual void Serialize(TagBuffer i) const {
+        i.WriteU64(m_txTime.GetTimeStep());
+        i.WriteU32(m_interface);
+    }
+    
+    virtual void Deserialize(TagBuffer i) {
+        m_txTime = TimeStep(i.ReadU64());
+        m_interface = i.ReadU32();
+    }
+    
+    virtual void Print(std::ostream& os) const {
+        os << "txTime=" << m_txTime << " interface=" << m_interface;
+    }
+    
+    Time GetTxTime() const {
+        return m_txTime;
+    }
+    
+    uint32_t GetInterface() const {
+        return m_interface;
+    }
+};
+
+// Entrée de la table de secours (paquets dont le tag a été retiré).
+// La table est à adressage direct sur l'uid : une collision écrase
+// simplement l'entrée la plus ancienne, la mémoire reste bornée.
+struct TxRecord {
+    uint64_t uid;
+    Time txTime;
+    uint32_t interface;
+    bool valid;
+    
+    TxRecord() : uid(0), interface(0), valid(false) {}
+};
+
+// ========================================
+// CLASSE: PathMetricsMonitor
+// ========================================
+
+class PathMetricsMonitor : public Object {
+private:
+    std::vector<TxRecord> m_txTable;
+    std::vector<PathMetrics> m_interfaceMetrics;      // Indexé par interface Ipv4
+    std::map<uint32_t, LatencyWindow> m_latencyHistory;
+    std::map<uint32_t, PathSketches> m_sketches;
+    std::map<uint32_t, std::vector<ThresholdSubscription>> m_subscriptions;
+    uint32_t m_nextSubscriptionId;
+    uint32_t m_latencyWindowSize;   // Nombre d'échantillons de la moyenne mobile
+    double m_ewmaAlpha;             // Poids du dernier échantillon dans l'EWMA
+    bool m_useTxTag;                // Horodatage dans le paquet (sinon table seule)
+    uint32_t m_txTableSize;         // Capacité de la table de secours
+    Time m_txTableMaxAge;           // Âge au-delà duquel une entrée est ignorée
+    Time m_sketchEpoch;             // Durée d'une époque des esquisses de quantiles
+    Time m_bandwidthInterval;       // Fenêtre de mesure du débit
+    Time m_lastBandwidthSample;
+    EventId m_bandwidthEvent;
+    Time m_staleAge;                // Âge au-delà duquel les métriques expirent (0 = jamais)
+    EventId m_staleEvent;
+    MetricsExporter* m_exporter;    // Export périodique (optionnel)
+    Time m_exportInterval;
+    EventId m_exportEvent;
+    
+public:
+    static TypeId GetTypeId();
+    PathMetricsMonitor();
+    virtual ~PathMetricsMonitor();
+    void Initialize();
+    void EnableLatencyTracking(Ptr<Node> node);
+    void EnableReceiveTracking(Ptr<Node> node);
+    void PacketSent(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+    static void DeviceTx(PathMetricsMonitor* monitor, uint32_t interface,
+                         Ptr<const Packet> packet);
+    void PacketReceivedTrace(std::string context, Ptr<const Packet> packet,
+                             Ptr<Ipv4> ipv4, uint32_t interface) {
+        PacketReceived(packet);
+    }
+    
+    void PacketReceived(Ptr<const Packet> packet);
+    
+    // Appelle callback(id, true) quand la métrique passe au-dessus de high et
+    // callback(id, false) quand elle repasse sous low. Retourne l'id.
+    uint32_t SubscribeThreshold(uint32_t interface, double low, double high, double percentile,
+                                Callback<void, uint32_t, bool> callback);
+    
+    // Nouvelle bande d'un abonnement portant sur ce percentile (0 = moyenne) ;
+    // l'état repart de « sous le seuil ». Retourne false sinon.
+    bool UpdateThreshold(uint32_t subscriptionId, double percentile, double low, double high);
+    
+private:
+    // Les quantiles coûtent un parcours de l'esquisse : ils ne sont
+    // réévalués que tous les QUANTILE_CHECK_PERIOD échantillons
+    static const uint32_t QUANTILE_CHECK_PERIOD = 64;
+    
+    void CheckThresholds(uint32_t interface, const PathMetrics& metrics,
+                         std::vector<ThresholdSubscription>& subs);
+    
+    // Seul point d'insertion dans m_interfaceMetrics : les accesseurs publics
+    // ne font que lire et renvoient 0 pour une interface inconnue
+    PathMetrics& MetricsFor(uint32_t interface);
+    
+    // Hachage du 5-tuple d'un paquet vu par la trace Ipv4L3Protocol/Rx
+    // (en-tête IP encore présent), 0 si l'en-tête manque
+    static uint64_t FlowOf(Ptr<const Packet> packet);
+    void RecordTx(Ptr<const Packet> packet, uint32_t interface);
+    bool LookupTx(uint64_t uid, Time& txTime, uint32_t& interface);
+    
+    // Un chemin délaissé après un basculement ne reçoit plus d'échantillons :
+    // ses métriques sont oubliées au bout de StaleAge (latence 0, quantiles
+    // vidés) et ses abonnements repassent sous le seuil, ce qui permet au
+    // contrôleur d'y revenir. Si le chemin est toujours dégradé, les
+    // nouveaux échantillons déclenchent un nouveau basculement.
+    void ExpireStaleMetrics();
+    
+public:
+    // Débit de chaque interface sur la dernière fenêtre, à partir des octets
+    // réellement émis sur cette interface (trace MacTx ou Ipv4 Tx) depuis
+    // l'échantillon précédent. Le coût ne dépend que du nombre d'interfaces.
+    void UpdateBandwidthMetrics();
+    
+    // Ajoute un enregistrement SERIES_PATH par interface à chaque intervalle ;
+    // l'écriture sur disque se fait dans le thread de l'exporteur
+    void StartExport(MetricsExporter* exporter, Time interval);
+    void ExportMetrics();
+    PathMetrics GetInterfaceMetrics(uint32_t interface) const;
+    
+    uint32_t GetNInterfaces() const {
+        return m_interfaceMetrics.size();
+    }
+    
+    double GetInterfaceLatency(uint32_t interface) const {
+        return (interface < m_interfaceMetrics.size()) ? m_interfaceMetrics[interface].latency : 0.0;
+    }
+    
+    // Copie la latence moyenne de toutes les interfaces en un seul parcours,
+    // pour une évaluation par lot des politiques (latency[i] = interface i)
+    void SnapshotLatencies(std::vector<double>& latency) const;
+    
+    // Quantile de latence (ms), ex: q = 0.99 pour le P99
+    double GetInterfaceLatencyPercentile(uint32_t interface, double q);
+    
+    // Quantile de gigue (ms)
+    double GetInterfaceJitterPercentile(uint32_t interface, double q);
+    
+    double GetInterfaceLatencyEwma(uint32_t interface) const {
+        return (interface < m_interfaceMetrics.size()) ? m_interfaceMetrics[interface].latencyEwma : 0.0;
+    }
+    
+    void SetLatencyWindow(uint32_t samples);
+    
+    double GetInterfaceBandwidth(uint32_t interface) const {
+        return (interface < m_interfaceMetrics.size()) ? m_interfaceMetrics[interface].bandwidth : 0.0;
+    }
+    
+    void PrintMetrics();
+};
+
+// ========================================
+// LECTURE RAPIDE DES EN-TÊTES
+// ========================================
+
+// Champs utiles à la classification. Les adresses, le TOS et le protocole
+// viennent de l'Ipv4Header déjà décodé par la pile ; seuls les ports sont
+// lus à offset fixe dans les octets du paquet (RFC 768 / RFC 793), sans
+// Packet::Copy() ni désérialisation des en-têtes ns-3.
+struct PacketFields {
+    uint32_t srcAddr;
+    uint32_t dstAddr;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint8_t tos;
+    uint8_t protocol;
+};
+
+// L'en-tête L4 commence à l4Offset dans payload (0 après retrait de l'en-tête
+// IP). Les ports restent à 0 pour les fragments non initiaux et les
+// protocoles autres que UDP/TCP.
+inline void ParseFields(const Ipv4Header& header, Ptr<const Packet> payload, PacketFields& fields,
+                        uint32_t l4Offset = 0) {
+    fields.srcAddr = header.GetSource().Get();
+    fields.dstAddr = header.GetDestination().Get();
+    fields.tos = header.GetTos();
+    fields.protocol = header.GetProtocol();
+    fields.srcPort = 0;
+    fields.dstPort = 0;
+    
+    bool hasPorts = fields.protocol == UdpL4Protocol::PROT_NUMBER ||
+                    fields.protocol == TcpL4Protocol::PROT_NUMBER;
+    if (hasPorts && header.GetFragmentOffset() == 0) {
+        uint8_t buf[64];            // En-tête IP de 60 octets au plus + ports
+        uint32_t length = l4Offset + 4;
+        if (length <= sizeof(buf) && payload->CopyData(buf, length) == length) {
+            fields.srcPort = (uint16_t(buf[l4Offset]) << 8) | buf[l4Offset + 1];
+            fields.dstPort = (uint16_t(buf[l4Offset + 2]) << 8) | buf[l4Offset + 3];
+        }
+    }
+}
+
+// ========================================
+// TABLES DE CLASSIFICATION
+// ========================================
+
+// Tables à indexation directe : une entrée par port (65536) et par DSCP (64).
+// La valeur UNCLASSIFIED signifie « pas de règle » pour ce port.
+inline constexpr uint8_t UNCLASSIFIED = 0xff;
+
+typedef std::array<uint8_t, 65536> PortClassTable;
+typedef std::array<uint8_t, 64> DscpClassTable;
+
+// Jeu de règles par défaut, construit à la compilation
+constexpr PortClassTable MakeDefaultPortTable() {
+    PortClassTable table{};
+    for (uint32_t port = 0; port < table.size(); port++) {
+        table[port] = UNCLASSIFIED;
+    }
+    table[5004] = VIDEO_TRAFFIC;    // Port RTP
+    table[5005] = VIDEO_TRAFFIC;
+    table[21] = DATA_TRAFFIC;       // Port FTP
+    table[9] = DATA_TRAFFIC;        // Port Bulk
+    return table;
+}
+
+constexpr DscpClassTable MakeDefaultDscpTable() {
+    DscpClassTable table{};
+    for (uint32_t dscp = 0; dscp < table.size(); dscp++) {
+        table[dscp] = DEFAULT_TRAFFIC;
+    }
+    table[46] = VIDEO_TRAFFIC;      // EF (Expedited Forwarding)
+    table[0] = DATA_TRAFFIC;        // Best Effort
+    return table;
+}
+
+inline constexpr PortClassTable DEFAULT_PORT_TABLE = MakeDefaultPortTable();
+inline constexpr DscpClassTable DEFAULT_DSCP_TABLE = MakeDefaultDscpTable();
+
+// ========================================
+// CACHE DE FLUX
+// ========================================
+
+// Hachage 64 bits du 5-tuple, partagé par le cache et la répartition multichemin
+inline uint64_t HashFlow(const PacketFields& f) {
+    uint64_t h = (uint64_t(f.srcAddr) << 32) | f.dstAddr;
+    h ^= ((uint64_t(f.srcPort) << 24) | (uint64_t(f.dstPort) << 8) | f.protocol) *
+         0x9e3779b97f4a7c15ull;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Entrée du cache : 5-tuple, classe résolue et interface de sortie.
+// La génération permet d'invalider toutes les entrées d'une classe en O(1).
+struct FlowCacheEntry {
+    uint32_t srcAddr;
+    uint32_t dstAddr;
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint8_t protocol;
+    uint8_t tclass;
+    bool valid;
+    uint32_t generation;
+    uint32_t egressInterface;
+    uint32_t pathEpoch;             // Poids multichemin ayant choisi l'interface
+    Time lastSeen;
+    
+    FlowCacheEntry()
+        : srcAddr(0), dstAddr(0), srcPort(0), dstPort(0), protocol(0),
+          tclass(DEFAULT_TRAFFIC), valid(false), generation(0), egressInterface(0),
+          pathEpoch(0) {}
+    
+    bool Matches(const PacketFields& f) const {
+        return valid && srcAddr == f.srcAddr && dstAddr == f.dstAddr &&
+               srcPort == f.srcPort && dstPort == f.dstPort && protocol == f.protocol;
+    }
+};
+
+// Table de hachage à adressage ouvert sur le 5-tuple. Le sondage linéaire est
+// borné à PROBE_LIMIT cases : une recherche parcourt toujours toute la fenêtre,
+// ce qui évite les marqueurs de suppression. Les entrées inactives depuis
+// plus de idleTimeout sont recyclées ; si la fenêtre est pleine, la moins
+// récemment utilisée est évincée.
+class FlowCache {
+public:
+    static const uint32_t PROBE_LIMIT = 8;
+    
+private:
+    std::vector<FlowCacheEntry> m_entries;
+    uint32_t m_mask;
+    Time m_idleTimeout;
+    std::array<uint32_t, NUM_TRAFFIC_CLASSES> m_classGeneration;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+    
+    static uint32_t Hash(const PacketFields& f) {
+        return uint32_t(HashFlow(f));
+    }
+    
+    bool IsLive(const FlowCacheEntry& entry, Time now) const {
+        return entry.valid && entry.generation == m_classGeneration[entry.tclass] &&
+               now - entry.lastSeen <= m_idleTimeout;
+    }
+    
+public:
+    FlowCache() : m_mask(0), m_hits(0), m_misses(0), m_evictions(0) {
+        m_classGeneration.fill(0);
+    }
+    
+    void Configure(uint32_t capacity, Time idleTimeout) {
+        uint32_t size = PROBE_LIMIT;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_entries.assign(size, FlowCacheEntry());
+        m_mask = size - 1;
+        m_idleTimeout = idleTimeout;
+    }
+    
+    bool IsConfigured() const {
+        return !m_entries.empty();
+    }
+    
+    // Retourne l'entrée vivante du flux, ou nullptr (défaut de cache) ;
+    // idle reçoit le temps écoulé depuis le paquet précédent du flux
+    FlowCacheEntry* Lookup(const PacketFields& f, Time now, Time* idle = nullptr) {
+        uint32_t base = Hash(f);
+        for (uint32_t i = 0; i < PROBE_LIMIT; i++) {
+            FlowCacheEntry& entry = m_entries[(base + i) & m_mask];
+            if (entry.Matches(f)) {
+                if (!IsLive(entry, now)) {
+                    entry.valid = false;
+                    break;
+                }
+                if (idle) {
+                    *idle = now - entry.lastSeen;
+                }
+                entry.lastSeen = now;
+                m_hits++;
+                return &entry;
+            }
+        }
+        m_misses++;
+        return nullptr;
+    }
+    
+    FlowCacheEntry* Insert(const PacketFields& f, TrafficClass tclass, uint32_t egressInterface, Time now) {
+        uint32_t base = Hash(f);
+        FlowCacheEntry* victim = nullptr;
+        for (uint32_t i = 0; i < PROBE_LIMIT; i++) {
+            FlowCacheEntry& entry = m_entries[(base + i) & m_mask];
+            if (!IsLive(entry, now)) {
+                victim = &entry;
+                break;
+            }
+            if (!victim || entry.lastSeen < victim->lastSeen) {
+                victim = &entry;
+            }
+        }
+        if (IsLive(*victim, now)) {
+            m_evictions++;
+        }
+        
+        victim->srcAddr = f.srcAddr;
+        victim->dstAddr = f.dstAddr;
+        victim->srcPort = f.srcPort;
+        victim->dstPort = f.dstPort;
+        victim->protocol = f.protocol;
+        victim->tclass = tclass;
+        victim->valid = true;
+        victim->generation = m_classGeneration[tclass];
+        victim->egressInterface = egressInterface;
+        victim->pathEpoch = 0;
+        victim->lastSeen = now;
+        return victim;
+    }
+    
+    // Invalide les flux d'une classe sans parcourir la table
+    void InvalidateClass(TrafficClass tclass) {
+        m_classGeneration[tclass]++;
+    }
+    
+    // Invalide tous les flux : une règle de classification peut déplacer
+    // vers la nouvelle classe des flux mis en cache sous n'importe quelle autre
+    void InvalidateAll() {
+        for (uint32_t& generation : m_classGeneration) {
+            generation++;
+        }
+    }
+    
+    uint64_t GetHits() const {
+        return m_hits;
+    }
+    
+    uint64_t GetMisses() const {
+        return m_misses;
+    }
+    
+    uint64_t GetEvictions() const {
+        return m_evictions;
+    }
+};
+
+// ========================================
+// CLASSE: PolicyBasedRouter
+// ========================================
+
+// Protocole de routage installé dans l'Ipv4ListRouting du routeur, avec une
+// priorité supérieure au routage global. Seuls les paquets entrant par une
+// interface LAN déclarée (AddSteeredIngress) sont orientés : leur classe
+// donne directement la route de sortie (tableau indexé par classe). Tout le
+// reste, y compris les classes sans interface, est laissé au protocole de
+// priorité inférieure en retournant false / nullptr.
+//
+// Multichemin : les classes déclarées (SetClassMultipath) sont réparties flux
+// par flux sur les interfaces candidates par hachage de rendez-vous pondéré
+// du 5-tuple ; les poids suivent la bande passante libre et la latence
+// mesurées par le PathMetricsMonitor. Un flux ne change de chemin qu'au début
+// d'une rafale (flowlet), après un silence de FlowletTimeout, pour ne pas
+// réordonner ses paquets. Les autres classes restent épinglées sur leur
+// interface (la vidéo sur le chemin choisi par le contrôleur SD-WAN).
+class PolicyBasedRouter : public Ipv4RoutingProtocol {
+private:
+    Ptr<Ipv4> m_ipv4;
+    PortClassTable m_portTable;
+    DscpClassTable m_dscpTable;
+    std::array<uint32_t, NUM_TRAFFIC_CLASSES> m_classInterface;   // 0 = pas d'orientation
+    std::vector<Ptr<Ipv4Route>> m_interfaceRoutes;                // Indexé par interface
+    std::map<uint32_t, Ipv4Address> m_gateways;                   // Prochains sauts configurés
+    std::vector<bool> m_steeredIngress;
+    uint32_t m_packetCount;
+    uint32_t m_nodeId;              // Pour le journal d'évènements
+    FlowCache m_flowCache;
+    uint32_t m_flowCacheSize;
+    Time m_flowIdleTimeout;
+    
+    // Multichemin pondéré
+    std::array<bool, NUM_TRAFFIC_CLASSES> m_classMultipath;
+    std::vector<uint32_t> m_pathInterfaces;
+    std::vector<double> m_pathCapacity;     // Mbps, 0 = débit du NetDevice
+    std::vector<double> m_pathWeights;
+    std::vector<uint64_t> m_pathFlows;      // Flux et flowlets attribués
+    uint32_t m_pathEpoch;                   // Incrémenté à chaque mise à jour des poids
+    Ptr<PathMetricsMonitor> m_pathMonitor;
+    Time m_flowletTimeout;
+    Time m_weightInterval;
+    EventId m_weightEvent;
+    uint64_t m_flowletMoves;
+    
+    static constexpr double MIN_PATH_SHARE = 0.05;  // Part minimale d'un chemin actif
+    static constexpr double WEIGHT_SMOOTHING = 0.25; // Poids de la nouvelle mesure
+    
+public:
+    static TypeId GetTypeId();
+    PolicyBasedRouter();
+    virtual ~PolicyBasedRouter();
+    
+    // Ajoute le PBR à l'Ipv4ListRouting du nœud, au-dessus du routage
+    // statique (0) et global (-10) installés par InternetStackHelper
+    void Install(Ptr<Node> node, int16_t priority = 10);
+    
+    // Interface dont le trafic entrant est soumis aux politiques
+    void AddSteeredIngress(uint32_t interface);
+    
+    // Prochain saut explicite ; par défaut, l'adresse du pair point-à-point
+    void SetInterfaceGateway(uint32_t interface, Ipv4Address gateway);
+    
+    // Règles ajoutées à l'exécution, par-dessus le jeu par défaut ; les flux
+    // en cache sont reclassés au paquet suivant
+    void AddPortRule(uint16_t port, TrafficClass tclass) {
+        m_portTable[port] = tclass;
+        m_flowCache.InvalidateAll();
+    }
+    
+    void RemovePortRule(uint16_t port) {
+        m_portTable[port] = UNCLASSIFIED;
+        m_flowCache.InvalidateAll();
+    }
+    
+    void AddDscpRule(uint8_t dscp, TrafficClass tclass) {
+        m_dscpTable[dscp & 0x3f] = tclass;
+        m_flowCache.InvalidateAll();
+    }
+    
+    TrafficClass ClassifyTraffic(uint16_t srcPort, uint16_t dstPort, uint8_t dscp);
+    
+    // Retourne l'interface de sortie du flux (0 si non orienté)
+    uint32_t ClassifyFlow(const PacketFields& fields, TrafficClass& tclass);
+    
+    // ===== Ipv4RoutingProtocol =====
+    
+    virtual Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p, const Ipv4Header& header,
+                                       Ptr<NetDevice> oif, Socket::SocketErrno& sockerr);
+    
+    virtual bool RouteInput(Ptr<const Packet> p, const Ipv4Header& header,
+                            Ptr<const NetDevice> idev, const UnicastForwardCallback& ucb,
+                            const MulticastForwardCallback& mcb, const LocalDeliverCallback& lcb,
+                            const ErrorCallback& ecb);
+    
+    virtual void NotifyInterfaceUp(uint32_t interface) {
+        RebuildRoutes();
+    }
+    
+    virtual void NotifyInterfaceDown(uint32_t interface) {
+        RebuildRoutes();
+    }
+    
+    virtual void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+        RebuildRoutes();
+    }
+    
+    virtual void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+        RebuildRoutes();
+    }
+    
+    virtual void SetIpv4(Ptr<Ipv4> ipv4);
+    virtual void PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+    
+    // ===== Pilotage par le contrôleur SD-WAN =====
+    
+    void UpdateClassInterface(TrafficClass tclass, uint32_t interface);
+    
+    uint32_t GetInterfaceForClass(TrafficClass tclass) {
+        return m_classInterface[tclass];
+    }
+    
+    void PrintFlowCacheStats();
+    
+    // ===== Multichemin pondéré =====
+    
+    // Interface candidate, capacité en Mbps (0 = attribut DataRate du NetDevice)
+    void AddMultipathInterface(uint32_t interface, double capacity = 0.0);
+    
+    // Répartit la classe sur les interfaces candidates au lieu de l'épingler
+    void SetClassMultipath(TrafficClass tclass, bool enable);
+    
+    // Poids recalculés toutes les MultipathInterval depuis le moniteur ; sans
+    // moniteur, chaque interface pèse sa capacité
+    void EnableMultipath(Ptr<PathMetricsMonitor> monitor);
+    
+    void UpdateMultipathWeights();
+    
+    // Interface gagnante pour le flux (0 si aucun chemin n'a de poids)
+    uint32_t SelectPath(const PacketFields& fields);
+    
+    double GetPathWeight(uint32_t path) const {
+        return m_pathWeights[path];
+    }
+    
+    void PrintMultipathStats();
+    
+protected:
+    virtual void DoDispose();
+    
+private:
+    // Capacité configurée, ou lue sur le NetDevice de l'interface
+    double ResolvePathCapacity(uint32_t path);
+    
+    // Adresse du pair sur un lien point-à-point (prochain saut implicite)
+    Ipv4Address DiscoverPeerAddress(uint32_t interface) const;
+    
+    // Une route pré-calculée par interface de sortie : la recherche par
+    // paquet se réduit à deux accès tableau (classe -> interface -> route)
+    void RebuildRoutes();
+};
+
+// ========================================
+// CLASSE: SdwanController
+// ========================================
+
+class SdwanController : public Object {
+private:
+    Ptr<Node> m_router;
+    Ptr<PathMetricsMonitor> m_monitor;
+    Ptr<PolicyBasedRouter> m_pbr;
+    PolicyTable m_policies;
+    std::vector<uint32_t> m_subscriptionPolicy;     // id d'abonnement -> id de politique
+    uint32_t m_maxInterface;                        // Plus grand index d'interface référencé
+    
+    // Clichés des métriques, pris une fois par époque d'évaluation
+    std::vector<double> m_latencySnapshot;          // ms, indexé par interface
+    std::vector<double> m_tailSnapshot;             // ms, indexé par tailSlot
+    std::vector<uint32_t> m_tailInterface;          // Clé (interface, quantile) de chaque slot
+    std::vector<double> m_tailQuantile;
+    std::vector<uint8_t> m_decisions;               // Résultat de la passe de décision
+    
+    EventId m_periodicEvent;
+    Time m_evaluationInterval;
+    bool m_eventDriven;             // Évaluation sur franchissement de seuil
+    Time m_holdDown;                // Délai minimal entre deux basculements
+    double m_restoreRatio;          // Retour au primaire sous ratio * seuil
+    uint32_t m_switchCount;
+    TracedCallback<uint32_t, uint32_t> m_switchTrace;   // (classe, nouvelle interface)
+    
+    static const uint32_t NO_POLICY = 0xffffffff;
+    static const uint8_t DECISION_SWITCH = 1;       // Basculer vers le secondaire
+    static const uint8_t DECISION_RESTORE = 2;      // Revenir au primaire
+    static const uint8_t DECISION_DEGRADED = 4;     // Primaire dégradé (indicateur)
+    
+public:
+    static TypeId GetTypeId();
+    SdwanController();
+    virtual ~SdwanController();
+    
+    void SetRouter(Ptr<Node> router) {
+        m_router = router;
+    }
+    
+    void SetMetricsMonitor(Ptr<PathMetricsMonitor> monitor) {
+        m_monitor = monitor;
+    }
+    
+    void SetPbr(Ptr<PolicyBasedRouter> pbr) {
+        m_pbr = pbr;
+    }
+    
+    // Préalloue les colonnes avant l'ajout d'un grand nombre de politiques
+    void ReservePolicies(uint32_t count) {
+        m_policies.Reserve(count);
+    }
+    
+    // Retourne l'identifiant dense de la politique (0, 1, 2, ...)
+    uint32_t AddPolicy(TrafficClass tclass, double latencyThresh, 
+                       uint32_t primaryIf, uint32_t secondaryIf);
+    
+    // Seuil complémentaire sur la queue de distribution (ex: P99 < 40 ms)
+    void SetTailLatencyThreshold(uint32_t policyId, double percentile, double thresholdMs);
+    
+    // Modifiable en cours de simulation : la politique est réévaluée aussitôt
+    // (sous réserve du hold-down)
+    void SetLatencyThreshold(uint32_t policyId, double thresholdMs);
+    void Start();
+    void Stop();
+    void PeriodicPolicyEvaluation();
+    
+    // Évaluation par lot : un cliché des métriques, une passe de décision sur
+    // toutes les lignes, puis l'application des seuls basculements retenus
+    void EvaluateAll();
+    
+    uint32_t GetPolicyCount() const {
+        return m_policies.Size();
+    }
+    
+    PolicyRule GetPolicy(uint32_t policyId) const {
+        return m_policies.Get(policyId);
+    }
+    
+    uint32_t GetSwitchCount() {
+        return m_switchCount;
+    }
+    
+private:
+    static const char* ClassName(TrafficClass tclass);
+    
+    // Les couples (interface, quantile) sont partagés entre politiques : un
+    // quantile n'est calculé qu'une fois par époque quel que soit le nombre
+    // de politiques qui le surveillent. Recherche linéaire, à la configuration.
+    uint32_t TailSlotFor(uint32_t interface, double percentile);
+    void MapSubscription(uint32_t subscriptionId, uint32_t policyId);
+    void SnapshotLatencies();
+    void TakeSnapshot();
+    
+    // Décision pour la ligne i à partir des clichés : uniquement des lectures
+    // de colonnes et des opérations booléennes sans branchement, afin que la
+    // boucle d'EvaluateAll reste vectorisable.
+    uint8_t Decide(uint32_t i, const double* latency, const double* tail, int64_t now) const;
+    void ApplyDecision(uint32_t id, uint8_t decision);
+    void OnThresholdCrossing(uint32_t subscriptionId, bool above);
+    
+    void DeferredEvaluation(uint32_t id) {
+        EvaluatePolicy(id);
+    }
+    
+    // Évaluation d'une seule ligne (mode événementiel) : seuls la latence des
+    // interfaces et le quantile surveillé par cette politique sont rafraîchis
+    void EvaluatePolicy(uint32_t id);
+};
+
+} // namespace ns3
+
+#endif // SDWAN_COMPONENTS_H
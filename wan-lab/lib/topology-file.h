@@ -0,0 +1,388 @@
+/*
+ * Compact, memory-mappable topology description
+ *
+ * A topology file is a fixed header followed by three arrays of 16-byte
+ * records, in this order:
+ *   header   { "TOPO", version, flags, partitions, nodes, profiles, links,
+ *              reserved } (32 bytes)
+ *   nodes    { role, reserved[3], systemId, x (f32), y (f32) }
+ *   profiles { data rate (bit/s, u64), delay (ns, i64) }
+ *   links    { node a, node b, network (host order), profile (u16),
+ *              prefix length (u8), reserved }
+ * Records are little-endian and naturally aligned, so TopologyFile maps the
+ * file read-only and hands out pointers into it: nothing is parsed or
+ * copied before the loader walks the arrays.
+ *
+ * Links share their rate and delay through the profile table: a 20k-node
+ * WAN with a handful of link types resolves a handful of attribute values,
+ * not one pair of strings per link. On a link, node a gets network + 1 and
+ * node b network + 2. Positions are meaningful only with FLAG_POSITIONS.
+ * systemId is the MPI rank the file was partitioned for (see partitions).
+ *
+ * TopologyFileWriter builds such a file in memory; see
+ * WanTopologyGenerator::Load() and Save() (wan-topology.h).
+ */
+
+#ifndef TOPOLOGY_FILE_H
+#define TOPOLOGY_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+enum TopologyNodeRole
+{
+    TOPOLOGY_ROUTER = 0, // Forwards IP packets between its links
+    TOPOLOGY_HOST = 1
+};
+
+struct TopologyFileHeader
+{
+    static constexpr uint32_t MAGIC = 0x4f504f54; // "TOPO"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t FLAG_POSITIONS = 0x1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t partitions; // Number of ranks the systemIds were assigned for
+    uint32_t nodeCount;
+    uint32_t profileCount;
+    uint32_t linkCount;
+    uint32_t reserved;
+};
+
+struct TopologyNodeRecord
+{
+    uint8_t role; // TopologyNodeRole
+    uint8_t reserved[3];
+    uint32_t systemId;
+    float x;
+    float y;
+};
+
+struct TopologyLinkProfile
+{
+    uint64_t dataRate; // bit/s
+    int64_t delay;     // ns
+};
+
+struct TopologyLinkRecord
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t network;
+    uint16_t profile;
+    uint8_t prefixLength;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TopologyFileHeader) == 32, "TopologyFileHeader layout");
+static_assert(sizeof(TopologyNodeRecord) == 16, "TopologyNodeRecord layout");
+static_assert(sizeof(TopologyLinkProfile) == 16, "TopologyLinkProfile layout");
+static_assert(sizeof(TopologyLinkRecord) == 16, "TopologyLinkRecord layout");
+
+// Read-only view of a topology file, valid until Close() or destruction
+class TopologyFile
+{
+  public:
+    TopologyFile()
+        : m_base(nullptr),
+          m_size(0),
+          m_header(nullptr),
+          m_nodes(nullptr),
+          m_profiles(nullptr),
+          m_links(nullptr)
+    {
+    }
+
+    ~TopologyFile()
+    {
+        Close();
+    }
+
+    TopologyFile(const TopologyFile&) = delete;
+    TopologyFile& operator=(const TopologyFile&) = delete;
+
+    // Maps and validates the file; on failure GetError() says why
+    bool Open(const std::string& filename)
+    {
+        Close();
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return Fail("cannot open " + filename);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(TopologyFileHeader))
+        {
+            close(fd);
+            return Fail(filename + " is too short for a topology file");
+        }
+        void* base = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (base == MAP_FAILED)
+        {
+            return Fail("cannot map " + filename);
+        }
+        m_base = static_cast<const char*>(base);
+        m_size = info.st_size;
+        return Validate(filename);
+    }
+
+    void Close()
+    {
+        if (m_base)
+        {
+            munmap(const_cast<char*>(m_base), m_size);
+        }
+        m_base = nullptr;
+        m_size = 0;
+        m_header = nullptr;
+        m_nodes = nullptr;
+        m_profiles = nullptr;
+        m_links = nullptr;
+    }
+
+    bool IsOpen() const
+    {
+        return m_header != nullptr;
+    }
+
+    const std::string& GetError() const
+    {
+        return m_error;
+    }
+
+    bool HasPositions() const
+    {
+        return m_header->flags & TopologyFileHeader::FLAG_POSITIONS;
+    }
+
+    uint32_t GetPartitions() const
+    {
+        return m_header->partitions;
+    }
+
+    uint32_t GetNNodes() const
+    {
+        return m_header->nodeCount;
+    }
+
+    uint32_t GetNProfiles() const
+    {
+        return m_header->profileCount;
+    }
+
+    uint32_t GetNLinks() const
+    {
+        return m_header->linkCount;
+    }
+
+    const TopologyNodeRecord* GetNodes() const
+    {
+        return m_nodes;
+    }
+
+    const TopologyLinkProfile* GetProfiles() const
+    {
+        return m_profiles;
+    }
+
+    const TopologyLinkRecord* GetLinks() const
+    {
+        return m_links;
+    }
+
+  private:
+    bool Fail(const std::string& error)
+    {
+        Close();
+        m_error = error;
+        return false;
+    }
+
+    bool Validate(const std::string& filename)
+    {
+        const TopologyFileHeader* header = reinterpret_cast<const TopologyFileHeader*>(m_base);
+        if (header->magic != TopologyFileHeader::MAGIC ||
+            header->version != TopologyFileHeader::VERSION)
+        {
+            return Fail(filename + " is not a version 1 topology file");
+        }
+        uint64_t expected = sizeof(TopologyFileHeader) +
+                            uint64_t(header->nodeCount) * sizeof(TopologyNodeRecord) +
+                            uint64_t(header->profileCount) * sizeof(TopologyLinkProfile) +
+                            uint64_t(header->linkCount) * sizeof(TopologyLinkRecord);
+        if (expected != m_size)
+        {
+            return Fail(filename + " is truncated or has trailing data");
+        }
+
+        const char* next = m_base + sizeof(TopologyFileHeader);
+        m_nodes = reinterpret_cast<const TopologyNodeRecord*>(next);
+        next += header->nodeCount * sizeof(TopologyNodeRecord);
+        m_profiles = reinterpret_cast<const TopologyLinkProfile*>(next);
+        next += header->profileCount * sizeof(TopologyLinkProfile);
+        m_links = reinterpret_cast<const TopologyLinkRecord*>(next);
+
+        // One pass over the nodes and the links, so that the loader can trust
+        // every role, rank and index
+        if (header->partitions == 0)
+        {
+            return Fail(filename + " has no partitions");
+        }
+        for (uint32_t n = 0; n < header->nodeCount; n++)
+        {
+            const TopologyNodeRecord& node = m_nodes[n];
+            if (node.role > TOPOLOGY_HOST || node.systemId >= header->partitions)
+            {
+                return Fail(filename + ": invalid node " + std::to_string(n));
+            }
+        }
+        for (uint32_t l = 0; l < header->linkCount; l++)
+        {
+            const TopologyLinkRecord& link = m_links[l];
+            if (link.a >= header->nodeCount || link.b >= header->nodeCount || link.a == link.b ||
+                link.profile >= header->profileCount || link.prefixLength < 8 ||
+                link.prefixLength > 30 || (link.network & ~(~0u << (32 - link.prefixLength))))
+            {
+                return Fail(filename + ": invalid link " + std::to_string(l));
+            }
+        }
+        m_header = header;
+        return true;
+    }
+
+    const char* m_base;
+    size_t m_size;
+    const TopologyFileHeader* m_header;
+    const TopologyNodeRecord* m_nodes;
+    const TopologyLinkProfile* m_profiles;
+    const TopologyLinkRecord* m_links;
+    std::string m_error;
+};
+
+// Builds a topology file in memory; profiles are deduplicated
+class TopologyFileWriter
+{
+  public:
+    TopologyFileWriter()
+        : m_positions(false),
+          m_partitions(1)
+    {
+    }
+
+    void Reserve(uint32_t nodes, uint32_t links)
+    {
+        m_nodes.reserve(nodes);
+        m_links.reserve(links);
+    }
+
+    void SetPartitions(uint32_t partitions)
+    {
+        m_partitions = partitions > 0 ? partitions : 1;
+    }
+
+    // Returns the node index
+    uint32_t AddNode(TopologyNodeRole role, uint32_t systemId = 0)
+    {
+        TopologyNodeRecord node = {};
+        node.role = role;
+        node.systemId = systemId;
+        m_nodes.push_back(node);
+        return m_nodes.size() - 1;
+    }
+
+    void SetPosition(uint32_t node, double x, double y)
+    {
+        m_nodes[node].x = float(x);
+        m_nodes[node].y = float(y);
+        m_positions = true;
+    }
+
+    // dataRate in bit/s, delay in ns, network in host byte order
+    void AddLink(uint32_t a,
+                 uint32_t b,
+                 uint64_t dataRate,
+                 int64_t delay,
+                 uint32_t network,
+                 uint8_t prefixLength)
+    {
+        TopologyLinkRecord link = {};
+        link.a = a;
+        link.b = b;
+        link.network = network;
+        link.profile = FindProfile(dataRate, delay);
+        link.prefixLength = prefixLength;
+        m_links.push_back(link);
+    }
+
+    bool Write(const std::string& filename) const
+    {
+        TopologyFileHeader header = {};
+        header.magic = TopologyFileHeader::MAGIC;
+        header.version = TopologyFileHeader::VERSION;
+        header.flags = m_positions ? TopologyFileHeader::FLAG_POSITIONS : 0;
+        header.partitions = m_partitions;
+        header.nodeCount = m_nodes.size();
+        header.profileCount = m_profiles.size();
+        header.linkCount = m_links.size();
+
+        FILE* file = std::fopen(filename.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(m_nodes.data(), sizeof(TopologyNodeRecord), m_nodes.size(), file) ==
+                      m_nodes.size() &&
+                  std::fwrite(m_profiles.data(),
+                              sizeof(TopologyLinkProfile),
+                              m_profiles.size(),
+                              file) == m_profiles.size() &&
+                  std::fwrite(m_links.data(), sizeof(TopologyLinkRecord), m_links.size(), file) ==
+                      m_links.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+  private:
+    // Linear search: WAN models use a few link types
+    uint16_t FindProfile(uint64_t dataRate, int64_t delay)
+    {
+        for (uint32_t p = 0; p < m_profiles.size(); p++)
+        {
+            if (m_profiles[p].dataRate == dataRate && m_profiles[p].delay == delay)
+            {
+                return p;
+            }
+        }
+        if (m_profiles.size() > UINT16_MAX)
+        {
+            std::fprintf(stderr, "topology-file: more than 65536 link profiles\n");
+            std::abort();
+        }
+        m_profiles.push_back(TopologyLinkProfile{dataRate, delay});
+        return m_profiles.size() - 1;
+    }
+
+    std::vector<TopologyNodeRecord> m_nodes;
+    std::vector<TopologyLinkProfile> m_profiles;
+    std::vector<TopologyLinkRecord> m_links;
+    bool m_positions;
+    uint32_t m_partitions;
+};
+
+} // namespace ns3
+
+#endif // TOPOLOGY_FILE_H
@@ -0,0 +1,103 @@
+/*
+ * Byte-level encoding shared by the compact binary traces (anim-trace.h,
+ * link-impairment.h): LEB128 varints, zigzag-encoded signed deltas, raw
+ * doubles, and a bounds-checked cursor to decode them.
+ */
+
+#ifndef TRACE_CODEC_H
+#define TRACE_CODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace trace_codec
+{
+
+inline void
+PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(uint8_t(value));
+}
+
+inline void
+PutZigzag(std::vector<uint8_t>& out, int64_t value)
+{
+    PutVarint(out, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+inline void
+PutDouble(std::vector<uint8_t>& out, double value)
+{
+    uint8_t bytes[sizeof(double)];
+    std::memcpy(bytes, &value, sizeof(bytes));
+    out.insert(out.end(), bytes, bytes + sizeof(bytes));
+}
+
+// Bounds-checked decoding cursor over one chunk
+struct Cursor
+{
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+    bool AtEnd() const
+    {
+        return pos >= size;
+    }
+
+    uint8_t Byte()
+    {
+        if (pos >= size)
+        {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    uint64_t Varint()
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t byte = Byte();
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        ok = false;
+        return value;
+    }
+
+    int64_t Zigzag()
+    {
+        uint64_t value = Varint();
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+
+    double Double()
+    {
+        double value = 0.0;
+        if (pos + sizeof(double) > size)
+        {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data + pos, sizeof(double));
+        pos += sizeof(double);
+        return value;
+    }
+};
+
+} // namespace trace_codec
+
+#endif // TRACE_CODEC_H
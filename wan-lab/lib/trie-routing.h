@@ -0,0 +1,621 @@
+/*
+ * Static routing backed by a longest-prefix-match multibit trie
+ *
+ * Drop-in alternative to Ipv4StaticRouting for large tables: the lookup
+ * cost is at most four node visits (stride 8: /1-/8, /9-/16, /17-/24,
+ * /25-/32) whatever the number of prefixes, instead of a walk over the
+ * whole route list.
+ *
+ * Each trie node holds 256 slots; a prefix of length L is stored in the
+ * node of its level by controlled prefix expansion over 2^(8k+8-L) slots,
+ * where a slot keeps the longest prefix of that level covering it. Insert
+ * and withdraw only rewrite the slots of the prefix concerned (withdraw
+ * re-exposes the next shorter prefix of the level, looked up in the exact
+ * prefix table).
+ *
+ * A prefix keeps its routes as metric-ordered alternates: lookups use the
+ * best alternate whose interface is up, then fall back to shorter prefixes.
+ * The route list API (GetNRoutes, GetRoute, GetMetric, RemoveRoute) mirrors
+ * Ipv4StaticRouting.
+ */
+
+#ifndef TRIE_ROUTING_H
+#define TRIE_ROUTING_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4TrieRouting : public Ipv4RoutingProtocol
+{
+  public:
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::Ipv4TrieRouting")
+                                .SetParent<Ipv4RoutingProtocol>()
+                                .SetGroupName("Internet")
+                                .AddConstructor<Ipv4TrieRouting>();
+        return tid;
+    }
+
+    Ipv4TrieRouting()
+        : m_root(new TrieNode()),
+          m_nodes(1)
+    {
+    }
+
+    void AddNetworkRouteTo(Ipv4Address network,
+                           Ipv4Mask networkMask,
+                           Ipv4Address nextHop,
+                           uint32_t interface,
+                           uint32_t metric = 0)
+    {
+        uint8_t length = networkMask.GetPrefixLength();
+        Prefix* prefix = FindOrInsertPrefix(network.CombineMask(networkMask).Get(), length);
+
+        // Metric-ordered, insertion order kept between equal metrics
+        auto it = prefix->alternates.begin();
+        while (it != prefix->alternates.end() && it->metric <= metric)
+        {
+            ++it;
+        }
+        prefix->alternates.insert(it, Alternate{nextHop, interface, metric});
+        m_routes.push_back(RouteRef{prefix, nextHop, interface, metric});
+    }
+
+    void AddNetworkRouteTo(Ipv4Address network,
+                           Ipv4Mask networkMask,
+                           uint32_t interface,
+                           uint32_t metric = 0)
+    {
+        AddNetworkRouteTo(network, networkMask, Ipv4Address::GetZero(), interface, metric);
+    }
+
+    void AddHostRouteTo(Ipv4Address dest,
+                        Ipv4Address nextHop,
+                        uint32_t interface,
+                        uint32_t metric = 0)
+    {
+        AddNetworkRouteTo(dest, Ipv4Mask::GetOnes(), nextHop, interface, metric);
+    }
+
+    void SetDefaultRoute(Ipv4Address nextHop, uint32_t interface, uint32_t metric = 0)
+    {
+        AddNetworkRouteTo(Ipv4Address::GetZero(), Ipv4Mask::GetZero(), nextHop, interface, metric);
+    }
+
+    uint32_t GetNRoutes() const
+    {
+        return m_routes.size();
+    }
+
+    uint32_t GetNPrefixes() const
+    {
+        return m_prefixes.size();
+    }
+
+    uint32_t GetNTrieNodes() const
+    {
+        return m_nodes;
+    }
+
+    Ipv4RoutingTableEntry GetRoute(uint32_t index) const
+    {
+        const RouteRef& route = m_routes.at(index);
+        Ipv4Address network(route.prefix->network);
+        Ipv4Mask mask(PrefixMask(route.prefix->length));
+        if (route.gateway == Ipv4Address::GetZero())
+        {
+            return Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, mask, route.interface);
+        }
+        return Ipv4RoutingTableEntry::CreateNetworkRouteTo(network,
+                                                           mask,
+                                                           route.gateway,
+                                                           route.interface);
+    }
+
+    uint32_t GetMetric(uint32_t index) const
+    {
+        return m_routes.at(index).metric;
+    }
+
+    // Swaps the last route into index: iterating backwards while removing
+    // stays valid, as with Ipv4StaticRouting
+    void RemoveRoute(uint32_t index)
+    {
+        NS_ABORT_MSG_IF(index >= m_routes.size(), "Route index out of range");
+        RouteRef route = m_routes[index];
+        m_routes[index] = m_routes.back();
+        m_routes.pop_back();
+
+        Prefix* prefix = route.prefix;
+        for (auto it = prefix->alternates.begin(); it != prefix->alternates.end(); ++it)
+        {
+            if (it->gateway == route.gateway && it->interface == route.interface &&
+                it->metric == route.metric)
+            {
+                prefix->alternates.erase(it);
+                break;
+            }
+        }
+        if (prefix->alternates.empty())
+        {
+            ErasePrefix(prefix);
+        }
+    }
+
+    // Withdraw one route by value; returns false if it is not installed
+    bool RemoveRoute(Ipv4Address network,
+                     Ipv4Mask networkMask,
+                     Ipv4Address nextHop,
+                     uint32_t interface)
+    {
+        uint8_t length = networkMask.GetPrefixLength();
+        uint32_t key = network.CombineMask(networkMask).Get();
+        if (!FindPrefix(key, length))
+        {
+            return false;
+        }
+        for (uint32_t i = m_routes.size(); i-- > 0;)
+        {
+            const RouteRef& route = m_routes[i];
+            if (route.prefix->network == key && route.prefix->length == length &&
+                route.gateway == nextHop && route.interface == interface)
+            {
+                RemoveRoute(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Ipv4RoutingProtocol
+
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override
+    {
+        Ipv4Address destination = header.GetDestination();
+        if (destination.IsMulticast())
+        {
+            sockerr = Socket::ERROR_NOROUTETOHOST;
+            return nullptr;
+        }
+        Ptr<Ipv4Route> route = Lookup(destination, oif);
+        sockerr = route ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+        return route;
+    }
+
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv4Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override
+    {
+        NS_ASSERT(m_ipv4->GetInterfaceForDevice(idev) >= 0);
+        uint32_t iif = m_ipv4->GetInterfaceForDevice(idev);
+        Ipv4Address destination = header.GetDestination();
+
+        if (destination.IsMulticast())
+        {
+            return false;
+        }
+        if (m_ipv4->IsDestinationAddress(destination, iif))
+        {
+            if (lcb.IsNull())
+            {
+                return false;
+            }
+            lcb(p, header, iif);
+            return true;
+        }
+        if (!m_ipv4->IsForwarding(iif))
+        {
+            ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+            return true;
+        }
+
+        Ptr<Ipv4Route> route = Lookup(destination, nullptr);
+        if (!route)
+        {
+            return false;
+        }
+        ucb(route, p, header);
+        return true;
+    }
+
+    void NotifyInterfaceUp(uint32_t interface) override
+    {
+        for (uint32_t j = 0; j < m_ipv4->GetNAddresses(interface); j++)
+        {
+            AddConnectedRoute(interface, m_ipv4->GetAddress(interface, j));
+        }
+    }
+
+    void NotifyInterfaceDown(uint32_t interface) override
+    {
+        // Gateway routes stay: lookups skip alternates on down interfaces
+        for (uint32_t i = m_routes.size(); i-- > 0;)
+        {
+            if (m_routes[i].interface == interface &&
+                m_routes[i].gateway == Ipv4Address::GetZero())
+            {
+                RemoveRoute(i);
+            }
+        }
+    }
+
+    void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) override
+    {
+        if (m_ipv4->IsUp(interface))
+        {
+            AddConnectedRoute(interface, address);
+        }
+    }
+
+    void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) override
+    {
+        if (address.GetMask() == Ipv4Mask::GetOnes())
+        {
+            return;
+        }
+        RemoveRoute(address.GetLocal().CombineMask(address.GetMask()),
+                    address.GetMask(),
+                    Ipv4Address::GetZero(),
+                    interface);
+    }
+
+    void SetIpv4(Ptr<Ipv4> ipv4) override
+    {
+        NS_ASSERT(!m_ipv4 && ipv4);
+        m_ipv4 = ipv4;
+        for (uint32_t i = 0; i < m_ipv4->GetNInterfaces(); i++)
+        {
+            if (m_ipv4->IsUp(i))
+            {
+                NotifyInterfaceUp(i);
+            }
+        }
+    }
+
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
+                           Time::Unit unit = Time::S) const override
+    {
+        std::ostream* os = stream->GetStream();
+        std::ios oldState(nullptr);
+        oldState.copyfmt(*os);
+        *os << std::resetiosflags(std::ios::adjustfield) << std::setiosflags(std::ios::left);
+
+        *os << "Node: " << m_ipv4->GetObject<Node>()->GetId()
+            << ", Time: " << Now().As(unit)
+            << ", Local time: " << m_ipv4->GetObject<Node>()->GetLocalTime().As(unit)
+            << ", Ipv4TrieRouting table (" << m_prefixes.size() << " prefixes, " << m_nodes
+            << " trie nodes)" << std::endl;
+        *os << "Destination     Gateway         Genmask         Flags Metric Ref    Use Iface"
+            << std::endl;
+        for (uint32_t i = 0; i < m_routes.size(); i++)
+        {
+            Ipv4RoutingTableEntry route = GetRoute(i);
+            std::ostringstream dest;
+            std::ostringstream gateway;
+            std::ostringstream mask;
+            dest << route.GetDest();
+            gateway << route.GetGateway();
+            mask << route.GetDestNetworkMask();
+            *os << std::setw(16) << dest.str() << std::setw(16) << gateway.str()
+                << std::setw(16) << mask.str() << std::setw(6)
+                << (route.IsGateway() ? "UG" : "U") << std::setw(7) << GetMetric(i)
+                << "-      -   " << route.GetInterface() << std::endl;
+        }
+        *os << std::endl;
+        (*os).copyfmt(oldState);
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        m_prefixes.clear();
+        m_routes.clear();
+        m_root.reset();
+        m_ipv4 = nullptr;
+        Ipv4RoutingProtocol::DoDispose();
+    }
+
+  private:
+    struct Alternate
+    {
+        Ipv4Address gateway;
+        uint32_t interface;
+        uint32_t metric;
+    };
+
+    struct Prefix
+    {
+        uint32_t network;
+        uint8_t length;
+        std::vector<Alternate> alternates; // Ascending metric
+    };
+
+    struct TrieNode
+    {
+        Prefix* route[256];  // Longest prefix of this level covering the slot
+        uint8_t length[256]; // Its length, 0 if none
+        std::unique_ptr<TrieNode> child[256];
+
+        TrieNode()
+        {
+            std::fill(route, route + 256, nullptr);
+            std::fill(length, length + 256, 0);
+        }
+    };
+
+    // Flat route list, for enumeration by index
+    struct RouteRef
+    {
+        Prefix* prefix;
+        Ipv4Address gateway;
+        uint32_t interface;
+        uint32_t metric;
+    };
+
+    static constexpr uint32_t STRIDE = 8;
+    static constexpr uint32_t LEVELS = 4;
+
+    static uint32_t PrefixMask(uint8_t length)
+    {
+        return length == 0 ? 0 : uint32_t(0xffffffff) << (32 - length);
+    }
+
+    static uint64_t PrefixKey(uint32_t network, uint8_t length)
+    {
+        return (uint64_t(network) << 8) | length;
+    }
+
+    static uint32_t Slot(uint32_t address, uint32_t level)
+    {
+        return (address >> (32 - STRIDE * (level + 1))) & 0xff;
+    }
+
+    Prefix* FindPrefix(uint32_t network, uint8_t length) const
+    {
+        auto it = m_prefixes.find(PrefixKey(network, length));
+        return it != m_prefixes.end() ? it->second.get() : nullptr;
+    }
+
+    Prefix* FindOrInsertPrefix(uint32_t network, uint8_t length)
+    {
+        std::unique_ptr<Prefix>& entry = m_prefixes[PrefixKey(network, length)];
+        if (!entry)
+        {
+            entry.reset(new Prefix{network, length, {}});
+            if (length > 0)
+            {
+                Expand(entry.get());
+            }
+        }
+        return entry.get();
+    }
+
+    void ErasePrefix(Prefix* prefix)
+    {
+        if (prefix->length > 0)
+        {
+            Withdraw(prefix);
+        }
+        m_prefixes.erase(PrefixKey(prefix->network, prefix->length));
+    }
+
+    // Node of the level of a prefix, created on the way if needed
+    TrieNode* LevelNode(uint32_t network, uint32_t level, bool create)
+    {
+        TrieNode* node = m_root.get();
+        for (uint32_t l = 0; l < level && node; l++)
+        {
+            std::unique_ptr<TrieNode>& child = node->child[Slot(network, l)];
+            if (!child && create)
+            {
+                child.reset(new TrieNode());
+                m_nodes++;
+            }
+            node = child.get();
+        }
+        return node;
+    }
+
+    void Expand(Prefix* prefix)
+    {
+        uint32_t level = (prefix->length - 1) / STRIDE;
+        TrieNode* node = LevelNode(prefix->network, level, true);
+        uint32_t span = 1u << (STRIDE * (level + 1) - prefix->length);
+        uint32_t first = Slot(prefix->network, level);
+        for (uint32_t slot = first; slot < first + span; slot++)
+        {
+            if (node->length[slot] <= prefix->length)
+            {
+                node->route[slot] = prefix;
+                node->length[slot] = prefix->length;
+            }
+        }
+    }
+
+    void Withdraw(Prefix* prefix)
+    {
+        uint32_t level = (prefix->length - 1) / STRIDE;
+        TrieNode* node = LevelNode(prefix->network, level, false);
+        if (!node)
+        {
+            return;
+        }
+        uint32_t span = 1u << (STRIDE * (level + 1) - prefix->length);
+        uint32_t first = Slot(prefix->network, level);
+        for (uint32_t slot = first; slot < first + span; slot++)
+        {
+            if (node->route[slot] != prefix)
+            {
+                continue;
+            }
+            // Next shorter prefix of the same level covering the slot
+            node->route[slot] = nullptr;
+            node->length[slot] = 0;
+            uint32_t address = (prefix->network & PrefixMask(STRIDE * level)) |
+                               (slot << (32 - STRIDE * (level + 1)));
+            for (uint8_t length = prefix->length - 1; length > STRIDE * level; length--)
+            {
+                Prefix* shorter = FindPrefix(address & PrefixMask(length), length);
+                if (shorter)
+                {
+                    node->route[slot] = shorter;
+                    node->length[slot] = length;
+                    break;
+                }
+            }
+        }
+    }
+
+    void AddConnectedRoute(uint32_t interface, Ipv4InterfaceAddress address)
+    {
+        if (address.GetLocal() == Ipv4Address() || address.GetMask() == Ipv4Mask::GetOnes())
+        {
+            return;
+        }
+        AddNetworkRouteTo(address.GetLocal().CombineMask(address.GetMask()),
+                          address.GetMask(),
+                          interface);
+    }
+
+    // Candidates from longest to shortest: at most one per level + default.
+    // A slot only keeps the longest prefix of its level, so when every
+    // alternate of a candidate is down, the shorter prefixes of the same
+    // level are looked up in the exact prefix table before the next level.
+    Ptr<Ipv4Route> Lookup(Ipv4Address destination, Ptr<NetDevice> oif) const
+    {
+        const Prefix* candidates[LEVELS + 1];
+        uint32_t count = 0;
+
+        const Prefix* defaultRoute = FindPrefix(0, 0);
+        if (defaultRoute)
+        {
+            candidates[count++] = defaultRoute;
+        }
+        uint32_t address = destination.Get();
+        const TrieNode* node = m_root.get();
+        for (uint32_t level = 0; level < LEVELS && node; level++)
+        {
+            uint32_t slot = Slot(address, level);
+            if (node->route[slot])
+            {
+                candidates[count++] = node->route[slot];
+            }
+            node = node->child[slot].get();
+        }
+
+        while (count-- > 0)
+        {
+            const Prefix* candidate = candidates[count];
+            Ptr<Ipv4Route> route = Resolve(candidate, destination, oif);
+            if (route)
+            {
+                return route;
+            }
+            if (candidate->length == 0)
+            {
+                continue;
+            }
+            uint32_t levelStart = STRIDE * ((candidate->length - 1) / STRIDE);
+            for (uint8_t length = candidate->length - 1; length > levelStart; length--)
+            {
+                const Prefix* shorter = FindPrefix(address & PrefixMask(length), length);
+                if (shorter && (route = Resolve(shorter, destination, oif)))
+                {
+                    return route;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    // Route over the best alternate of the prefix whose interface is up
+    Ptr<Ipv4Route> Resolve(const Prefix* prefix,
+                           Ipv4Address destination,
+                           Ptr<NetDevice> oif) const
+    {
+        for (const Alternate& alternate : prefix->alternates)
+        {
+            if (!m_ipv4->IsUp(alternate.interface))
+            {
+                continue;
+            }
+            Ptr<NetDevice> device = m_ipv4->GetNetDevice(alternate.interface);
+            if (oif && oif != device)
+            {
+                continue;
+            }
+            Ptr<Ipv4Route> route = Create<Ipv4Route>();
+            route->SetDestination(destination);
+            route->SetGateway(alternate.gateway);
+            route->SetSource(m_ipv4->SourceAddressSelection(alternate.interface, destination));
+            route->SetOutputDevice(device);
+            return route;
+        }
+        return nullptr;
+    }
+
+    Ptr<Ipv4> m_ipv4;
+    std::unique_ptr<TrieNode> m_root;
+    uint32_t m_nodes;
+    std::unordered_map<uint64_t, std::unique_ptr<Prefix>> m_prefixes;
+    std::vector<RouteRef> m_routes;
+};
+
+class Ipv4TrieRoutingHelper : public Ipv4RoutingHelper
+{
+  public:
+    Ipv4TrieRoutingHelper* Copy() const override
+    {
+        return new Ipv4TrieRoutingHelper(*this);
+    }
+
+    Ptr<Ipv4RoutingProtocol> Create(Ptr<Node> node) const override
+    {
+        return CreateObject<Ipv4TrieRouting>();
+    }
+
+    // The trie protocol of a node, alone or inside an Ipv4ListRouting
+    static Ptr<Ipv4TrieRouting> GetTrieRouting(Ptr<Ipv4> ipv4)
+    {
+        Ptr<Ipv4RoutingProtocol> protocol = ipv4->GetRoutingProtocol();
+        Ptr<Ipv4TrieRouting> trie = DynamicCast<Ipv4TrieRouting>(protocol);
+        if (trie)
+        {
+            return trie;
+        }
+        Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>(protocol);
+        for (uint32_t i = 0; list && i < list->GetNRoutingProtocols(); i++)
+        {
+            int16_t priority;
+            trie = DynamicCast<Ipv4TrieRouting>(list->GetRoutingProtocol(i, priority));
+            if (trie)
+            {
+                return trie;
+            }
+        }
+        return nullptr;
+    }
+};
+
+} // namespace ns3
+
+#endif // TRIE_ROUTING_H
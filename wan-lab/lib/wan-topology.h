@@ -0,0 +1,538 @@
+/*
+ * N-site WAN topology generator
+ *
+ * Builds full-mesh, hub-and-spoke or partial-mesh WANs of point-to-point
+ * links between site routers, with automatic per-link subnet allocation.
+ *
+ * Conventions:
+ * - Site 0 is HQ (the hub in hub-and-spoke), site N-1 is the DC
+ * - Partial mesh: circulant graph, each site is linked to its meshDegree
+ *   nearest neighbours on a ring (connected, deterministic on every rank)
+ * - Link k gets the k-th subnet of the configured prefix length, starting
+ *   at the address base (10.1.1.0/24 by default, as in the triangle)
+ *
+ * Distributed mode: sites are partitioned into contiguous blocks, one per
+ * MPI rank (node system id). Every rank builds the whole topology; links
+ * whose ends live on different ranks become PointToPointRemoteChannels and
+ * their delay is the lookahead between ranks.
+ *
+ * Instead of generating, Load() instantiates a topology file (see
+ * topology-file.h) in bulk, and Save() writes the current topology as one.
+ */
+
+#ifndef WAN_TOPOLOGY_H
+#define WAN_TOPOLOGY_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include "topology-file.h"
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+enum WanTopologyType
+{
+    WAN_FULL_MESH,
+    WAN_HUB_AND_SPOKE,
+    WAN_PARTIAL_MESH
+};
+
+inline bool
+ParseWanTopologyType(const std::string& name, WanTopologyType& type)
+{
+    if (name == "full-mesh")
+    {
+        type = WAN_FULL_MESH;
+    }
+    else if (name == "hub-and-spoke")
+    {
+        type = WAN_HUB_AND_SPOKE;
+    }
+    else if (name == "partial-mesh")
+    {
+        type = WAN_PARTIAL_MESH;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// One point-to-point link between sites a and b (a < b)
+struct WanLink
+{
+    uint32_t a;
+    uint32_t b;
+    NetDeviceContainer devices;        // devices.Get(0) on a, Get(1) on b
+    Ipv4InterfaceContainer interfaces; // interfaces.GetAddress(0) on a
+};
+
+class WanTopologyGenerator
+{
+  public:
+    WanTopologyGenerator()
+        : m_type(WAN_FULL_MESH),
+          m_meshDegree(4),
+          m_base("10.1.1.0"),
+          m_prefixLength(24),
+          m_systemCount(1),
+          m_systemId(0)
+    {
+        m_p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+        m_p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+    }
+
+    void SetTopology(WanTopologyType type, uint32_t meshDegree = 4)
+    {
+        m_type = type;
+        m_meshDegree = meshDegree;
+    }
+
+    void SetLinkAttributes(const std::string& dataRate, const std::string& delay)
+    {
+        m_p2p.SetDeviceAttribute("DataRate", StringValue(dataRate));
+        m_p2p.SetChannelAttribute("Delay", StringValue(delay));
+    }
+
+    // Subnets of /prefixLength allocated one per link from base
+    void SetAddressBase(const std::string& base, uint32_t prefixLength)
+    {
+        NS_ABORT_MSG_IF(prefixLength < 8 || prefixLength > 30,
+                        "Link prefix length must be between /8 and /30");
+        m_base = Ipv4Address(base.c_str());
+        m_prefixLength = prefixLength;
+    }
+
+    // systemCount ranks in total, this process being systemId
+    void SetPartitions(uint32_t systemCount, uint32_t systemId)
+    {
+        m_systemCount = systemCount > 0 ? systemCount : 1;
+        m_systemId = systemId;
+    }
+
+    void Build(uint32_t sites)
+    {
+        NS_ABORT_MSG_IF(sites < 2, "A WAN needs at least two sites");
+        NS_ABORT_MSG_IF(!m_links.empty(), "Topology already built");
+
+        for (uint32_t s = 0; s < sites; s++)
+        {
+            m_sites.Add(CreateObject<Node>(GetSiteRank(s, sites)));
+        }
+
+        switch (m_type)
+        {
+        case WAN_FULL_MESH:
+            for (uint32_t a = 0; a < sites; a++)
+            {
+                for (uint32_t b = a + 1; b < sites; b++)
+                {
+                    AddLink(a, b);
+                }
+            }
+            break;
+        case WAN_HUB_AND_SPOKE:
+            for (uint32_t s = 1; s < sites; s++)
+            {
+                AddLink(0, s);
+            }
+            break;
+        case WAN_PARTIAL_MESH: {
+            uint32_t reach = std::max<uint32_t>(1, m_meshDegree / 2);
+            for (uint32_t a = 0; a < sites; a++)
+            {
+                for (uint32_t k = 1; k <= reach && k < sites; k++)
+                {
+                    uint32_t b = (a + k) % sites;
+                    if (FindLink(a, b) < 0)
+                    {
+                        AddLink(std::min(a, b), std::max(a, b));
+                    }
+                }
+            }
+            break;
+        }
+        }
+
+        InternetStackHelper stack;
+        stack.Install(m_sites);
+        AssignAddresses();
+
+        for (uint32_t s = 0; s < sites; s++)
+        {
+            m_sites.Get(s)->GetObject<Ipv4>()->SetAttribute("IpForward", BooleanValue(true));
+        }
+    }
+
+    // Instantiates a topology file in bulk. Devices and channels are created
+    // directly, with attribute values resolved once per link profile rather
+    // than once per link, and the addresses of the file are assigned without
+    // Ipv4AddressHelper (and its global allocation bookkeeping). The file
+    // partitioning is kept when it was made for the same number of ranks;
+    // otherwise sites are split into contiguous blocks as in Build().
+    void Load(const std::string& filename)
+    {
+        NS_ABORT_MSG_IF(!m_links.empty() || m_sites.GetN() > 0, "Topology already built");
+        TopologyFile file;
+        NS_ABORT_MSG_IF(!file.Open(filename), file.GetError());
+        NS_ABORT_MSG_IF(file.GetNNodes() < 2, "A WAN needs at least two sites");
+
+        uint32_t sites = file.GetNNodes();
+        const TopologyNodeRecord* nodes = file.GetNodes();
+        bool keepPartitions = (file.GetPartitions() == m_systemCount);
+        for (uint32_t s = 0; s < sites; s++)
+        {
+            uint32_t rank = keepPartitions ? nodes[s].systemId : GetSiteRank(s, sites);
+            m_sites.Add(CreateObject<Node>(rank));
+        }
+        if (file.HasPositions())
+        {
+            m_positions.reserve(sites);
+            for (uint32_t s = 0; s < sites; s++)
+            {
+                m_positions.push_back(Vector(nodes[s].x, nodes[s].y, 0.0));
+            }
+        }
+
+        const TopologyLinkProfile* profiles = file.GetProfiles();
+        std::vector<DataRate> rates;
+        std::vector<ObjectFactory> channels;
+        rates.reserve(file.GetNProfiles());
+        channels.reserve(file.GetNProfiles());
+        for (uint32_t p = 0; p < file.GetNProfiles(); p++)
+        {
+            rates.push_back(DataRate(profiles[p].dataRate));
+            ObjectFactory channel("ns3::PointToPointChannel");
+            channel.Set("Delay", TimeValue(NanoSeconds(profiles[p].delay)));
+            channels.push_back(channel);
+        }
+        ObjectFactory deviceFactory("ns3::PointToPointNetDevice");
+        ObjectFactory queueFactory("ns3::DropTailQueue<Packet>");
+
+        uint32_t linkCount = file.GetNLinks();
+        const TopologyLinkRecord* records = file.GetLinks();
+        m_links.resize(linkCount);
+        m_linkIndex.reserve(linkCount);
+        for (uint32_t l = 0; l < linkCount; l++)
+        {
+            const TopologyLinkRecord& record = records[l];
+            WanLink& link = m_links[l];
+            link.a = std::min(record.a, record.b);
+            link.b = std::max(record.a, record.b);
+            NS_ABORT_MSG_IF(!m_linkIndex.emplace(LinkKey(link.a, link.b), l).second,
+                            filename << ": duplicate link " << link.a << "-" << link.b);
+
+            Ptr<Node> a = m_sites.Get(link.a);
+            Ptr<Node> b = m_sites.Get(link.b);
+            if (a->GetSystemId() != b->GetSystemId())
+            {
+                // Cross-rank link: the helper sets up the remote channel
+                m_p2p.SetDeviceAttribute("DataRate", DataRateValue(rates[record.profile]));
+                m_p2p.SetChannelAttribute("Delay",
+                                          TimeValue(NanoSeconds(profiles[record.profile].delay)));
+                link.devices = m_p2p.Install(a, b);
+                continue;
+            }
+            Ptr<PointToPointChannel> channel =
+                channels[record.profile].Create<PointToPointChannel>();
+            link.devices.Add(
+                CreateLinkDevice(a, channel, deviceFactory, queueFactory, rates[record.profile]));
+            link.devices.Add(
+                CreateLinkDevice(b, channel, deviceFactory, queueFactory, rates[record.profile]));
+        }
+
+        InternetStackHelper stack;
+        stack.Install(m_sites);
+
+        TrafficControlHelper trafficControl = TrafficControlHelper::Default();
+        for (uint32_t l = 0; l < linkCount; l++)
+        {
+            const TopologyLinkRecord& record = records[l];
+            Ipv4Mask mask(uint32_t(0xffffffff) << (32 - record.prefixLength));
+            // The file's node a gets network + 1, whichever end it is here
+            bool swapped = record.a > record.b;
+            AssignAddress(m_links[l], 0, Ipv4Address(record.network + (swapped ? 2 : 1)), mask,
+                          trafficControl);
+            AssignAddress(m_links[l], 1, Ipv4Address(record.network + (swapped ? 1 : 2)), mask,
+                          trafficControl);
+        }
+
+        for (uint32_t s = 0; s < sites; s++)
+        {
+            bool router = nodes[s].role == TOPOLOGY_ROUTER;
+            m_sites.Get(s)->GetObject<Ipv4>()->SetAttribute("IpForward", BooleanValue(router));
+        }
+    }
+
+    // Writes the current topology in the format read by Load(); positions
+    // are saved when the sites have a mobility model (after Layout())
+    bool Save(const std::string& filename) const
+    {
+        TopologyFileWriter writer;
+        writer.Reserve(m_sites.GetN(), m_links.size());
+        writer.SetPartitions(m_systemCount);
+        for (uint32_t s = 0; s < m_sites.GetN(); s++)
+        {
+            Ptr<Node> site = m_sites.Get(s);
+            BooleanValue forward;
+            site->GetObject<Ipv4>()->GetAttribute("IpForward", forward);
+            uint32_t node = writer.AddNode(forward.Get() ? TOPOLOGY_ROUTER : TOPOLOGY_HOST,
+                                           site->GetSystemId());
+            Ptr<MobilityModel> mobility = site->GetObject<MobilityModel>();
+            if (mobility)
+            {
+                Vector position = mobility->GetPosition();
+                writer.SetPosition(node, position.x, position.y);
+            }
+        }
+        for (const WanLink& link : m_links)
+        {
+            DataRateValue rate;
+            link.devices.Get(0)->GetAttribute("DataRate", rate);
+            TimeValue delay;
+            link.devices.Get(0)->GetChannel()->GetAttribute("Delay", delay);
+            std::pair<Ptr<Ipv4>, uint32_t> end = link.interfaces.Get(0);
+            Ipv4InterfaceAddress address = end.first->GetAddress(end.second, 0);
+            writer.AddLink(link.a,
+                           link.b,
+                           rate.Get().GetBitRate(),
+                           delay.Get().GetNanoSeconds(),
+                           address.GetLocal().CombineMask(address.GetMask()).Get(),
+                           address.GetMask().GetPrefixLength());
+        }
+        return writer.Write(filename);
+    }
+
+    // Circle layout for NetAnim; the hub sits in the centre. A loaded
+    // topology with positions keeps those of the file.
+    void Layout(double radius = 50.0)
+    {
+        MobilityHelper mobility;
+        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        mobility.Install(m_sites);
+
+        uint32_t sites = m_sites.GetN();
+        if (!m_positions.empty())
+        {
+            for (uint32_t s = 0; s < sites; s++)
+            {
+                m_sites.Get(s)->GetObject<MobilityModel>()->SetPosition(m_positions[s]);
+            }
+            return;
+        }
+        uint32_t first = (m_type == WAN_HUB_AND_SPOKE) ? 1 : 0;
+        for (uint32_t s = 0; s < sites; s++)
+        {
+            Vector position(radius, radius, 0.0);
+            if (s >= first)
+            {
+                double angle = 2.0 * M_PI * (s - first) / (sites - first);
+                position.x += radius * std::sin(angle);
+                position.y -= radius * std::cos(angle);
+            }
+            m_sites.Get(s)->GetObject<MobilityModel>()->SetPosition(position);
+        }
+    }
+
+    uint32_t GetSiteRank(uint32_t site, uint32_t sites) const
+    {
+        return uint64_t(site) * m_systemCount / sites;
+    }
+
+    bool IsLocal(uint32_t site) const
+    {
+        return m_sites.Get(site)->GetSystemId() == m_systemId;
+    }
+
+    NodeContainer GetLocalSites() const
+    {
+        NodeContainer local;
+        for (uint32_t s = 0; s < m_sites.GetN(); s++)
+        {
+            if (IsLocal(s))
+            {
+                local.Add(m_sites.Get(s));
+            }
+        }
+        return local;
+    }
+
+    uint32_t GetNSites() const
+    {
+        return m_sites.GetN();
+    }
+
+    Ptr<Node> GetSite(uint32_t site) const
+    {
+        return m_sites.Get(site);
+    }
+
+    const NodeContainer& GetSites() const
+    {
+        return m_sites;
+    }
+
+    std::string GetSiteName(uint32_t site) const
+    {
+        if (site == 0)
+        {
+            return "HQ";
+        }
+        if (site == m_sites.GetN() - 1)
+        {
+            return "DC";
+        }
+        return "Branch" + std::to_string(site);
+    }
+
+    const std::vector<WanLink>& GetLinks() const
+    {
+        return m_links;
+    }
+
+    // Index of the link between a and b, or -1
+    int32_t FindLink(uint32_t a, uint32_t b) const
+    {
+        auto it = m_linkIndex.find(LinkKey(a, b));
+        return it != m_linkIndex.end() ? int32_t(it->second) : -1;
+    }
+
+    // Address of the site on its first link
+    Ipv4Address GetSiteAddress(uint32_t site) const
+    {
+        return m_sites.Get(site)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+    }
+
+    uint32_t GetCrossRankLinks() const
+    {
+        uint32_t count = 0;
+        for (const WanLink& link : m_links)
+        {
+            if (m_sites.Get(link.a)->GetSystemId() != m_sites.Get(link.b)->GetSystemId())
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    PointToPointHelper& GetLinkHelper()
+    {
+        return m_p2p;
+    }
+
+  private:
+    static uint64_t LinkKey(uint32_t a, uint32_t b)
+    {
+        if (a > b)
+        {
+            std::swap(a, b);
+        }
+        return (uint64_t(a) << 32) | b;
+    }
+
+    void AddLink(uint32_t a, uint32_t b)
+    {
+        WanLink link;
+        link.a = a;
+        link.b = b;
+        link.devices = m_p2p.Install(m_sites.Get(a), m_sites.Get(b));
+        m_linkIndex[LinkKey(a, b)] = m_links.size();
+        m_links.push_back(link);
+    }
+
+    // What PointToPointHelper::Install() does for one end of a link
+    static Ptr<PointToPointNetDevice> CreateLinkDevice(Ptr<Node> node,
+                                                       Ptr<PointToPointChannel> channel,
+                                                       const ObjectFactory& deviceFactory,
+                                                       const ObjectFactory& queueFactory,
+                                                       const DataRate& rate)
+    {
+        Ptr<PointToPointNetDevice> device = deviceFactory.Create<PointToPointNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        device->SetDataRate(rate);
+        node->AddDevice(device);
+        Ptr<Queue<Packet>> queue = queueFactory.Create<Queue<Packet>>();
+        device->SetQueue(queue);
+        Ptr<NetDeviceQueueInterface> queueInterface = CreateObject<NetDeviceQueueInterface>();
+        queueInterface->GetTxQueue(0)->ConnectQueueTraces(queue);
+        device->AggregateObject(queueInterface);
+        device->Attach(channel);
+        return device;
+    }
+
+    // What Ipv4AddressHelper::Assign() does for one device, given its address
+    static void AssignAddress(WanLink& link,
+                              uint32_t end,
+                              Ipv4Address address,
+                              Ipv4Mask mask,
+                              TrafficControlHelper& trafficControl)
+    {
+        Ptr<NetDevice> device = link.devices.Get(end);
+        Ptr<Node> node = device->GetNode();
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        int32_t interface = ipv4->GetInterfaceForDevice(device);
+        if (interface < 0)
+        {
+            interface = ipv4->AddInterface(device);
+        }
+        ipv4->AddAddress(interface, Ipv4InterfaceAddress(address, mask));
+        ipv4->SetMetric(interface, 1);
+        ipv4->SetUp(interface);
+        link.interfaces.Add(ipv4, interface);
+
+        Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+        if (tc && !tc->GetRootQueueDiscOnDevice(device))
+        {
+            trafficControl.Install(device);
+        }
+    }
+
+    void AssignAddresses()
+    {
+        // Subnets available between the base and the end of its /8
+        uint32_t hostBits = 32 - m_prefixLength;
+        uint64_t available = ((uint64_t(1) << 24) - (m_base.Get() & 0x00ffffff)) >> hostBits;
+        NS_ABORT_MSG_IF(m_links.size() > available,
+                        m_links.size() << " links do not fit in /" << m_prefixLength
+                                       << " subnets from " << m_base
+                                       << "; use a longer link prefix (e.g. /30)");
+
+        Ipv4Mask mask(uint32_t(0xffffffff) << hostBits);
+        Ipv4AddressHelper address;
+        address.SetBase(m_base, mask);
+        for (WanLink& link : m_links)
+        {
+            link.interfaces = address.Assign(link.devices);
+            address.NewNetwork();
+        }
+    }
+
+    WanTopologyType m_type;
+    uint32_t m_meshDegree;
+    Ipv4Address m_base;
+    uint32_t m_prefixLength;
+    uint32_t m_systemCount;
+    uint32_t m_systemId;
+
+    PointToPointHelper m_p2p;
+    NodeContainer m_sites;
+    std::vector<WanLink> m_links;
+    std::unordered_map<uint64_t, uint32_t> m_linkIndex;
+    std::vector<Vector> m_positions; // From a loaded file, if it has them
+};
+
+} // namespace ns3
+
+#endif // WAN_TOPOLOGY_H
@@ -0,0 +1,199 @@
+/*
+ * What-if runs sharing one warmup
+ *
+ * WarmupFork::Run() runs the simulation up to the warmup time, then forks
+ * one child process per variant, at most jobs at a time. A child starts
+ * from a copy-on-write image of the parent: topology, routes, TCP windows,
+ * generators and queued events are not rebuilt. It calls apply(variant) at
+ * the warmup instant, resumes Simulator::Run() until the stop event the
+ * scenario scheduled, calls finish(variant), destroys the simulator and
+ * exits with finish()'s return value. Its standard output and error go to
+ * <logPrefix>-<variant name>.log.
+ *
+ * The parent never simulates past the warmup, so the children forked last
+ * start from the same state as the first ones. Files opened before the
+ * fork (PCAP, event log, exporters) would be shared by every child: the
+ * scenarios turn those outputs off in this mode and write their per-variant
+ * metrics from finish().
+ *
+ * Variants are written "key=value,key=value;key=value;..."; name=... sets the
+ * name of a variant (default v<index>).
+ */
+
+#ifndef WARMUP_FORK_H
+#define WARMUP_FORK_H
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+struct WarmupVariant
+{
+    std::string name;
+    std::map<std::string, std::string> values;
+
+    bool Has(const std::string& key) const
+    {
+        return values.count(key) > 0;
+    }
+
+    std::string Get(const std::string& key, const std::string& fallback = "") const
+    {
+        auto it = values.find(key);
+        return it != values.end() ? it->second : fallback;
+    }
+
+    double GetDouble(const std::string& key, double fallback) const
+    {
+        return Has(key) ? std::stod(Get(key)) : fallback;
+    }
+
+    // First key outside allowed, or "" when every key is known
+    std::string FindUnknownKey(const std::set<std::string>& allowed) const
+    {
+        for (const auto& value : values)
+        {
+            if (value.first != "name" && !allowed.count(value.first))
+            {
+                return value.first;
+            }
+        }
+        return "";
+    }
+};
+
+class WarmupFork
+{
+  public:
+    typedef std::function<void(const WarmupVariant&)> ApplyCallback;
+    typedef std::function<int(const WarmupVariant&)> FinishCallback;
+
+    static std::vector<WarmupVariant> ParseVariants(const std::string& spec)
+    {
+        std::vector<WarmupVariant> variants;
+        std::stringstream list(spec);
+        std::string item;
+        while (std::getline(list, item, ';'))
+        {
+            WarmupVariant variant;
+            std::stringstream fields(item);
+            std::string field;
+            while (std::getline(fields, field, ','))
+            {
+                size_t equal = field.find('=');
+                if (equal == std::string::npos)
+                {
+                    NS_FATAL_ERROR("Variant field without '=': " << field);
+                }
+                variant.values[field.substr(0, equal)] = field.substr(equal + 1);
+            }
+            if (variant.values.empty())
+            {
+                continue;
+            }
+            variant.name = variant.Get("name", "v" + std::to_string(variants.size()));
+            variants.push_back(variant);
+        }
+        return variants;
+    }
+
+    // Returns, in the parent, the number of children that failed; the
+    // simulator is left at the warmup time for the caller to destroy
+    static uint32_t Run(Time warmup,
+                        const std::vector<WarmupVariant>& variants,
+                        uint32_t jobs,
+                        const std::string& logPrefix,
+                        ApplyCallback apply,
+                        FinishCallback finish)
+    {
+        if (jobs == 0)
+        {
+            jobs = std::max<long>(1, sysconf(_SC_NPROCESSORS_ONLN));
+        }
+        Simulator::Stop(warmup - Simulator::Now());
+        Simulator::Run();
+        std::cout << "Warmup done at " << Simulator::Now().As(Time::S) << ", forking "
+                  << variants.size() << " variants, " << jobs << " at a time" << std::endl;
+
+        std::map<pid_t, uint32_t> running;
+        uint32_t next = 0;
+        uint32_t failures = 0;
+        while (next < variants.size() || !running.empty())
+        {
+            while (next < variants.size() && running.size() < jobs)
+            {
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(nullptr);
+                pid_t pid = fork();
+                if (pid < 0)
+                {
+                    NS_FATAL_ERROR("fork() failed");
+                }
+                if (pid == 0)
+                {
+                    RunChild(variants[next], logPrefix, apply, finish);
+                }
+                running[pid] = next++;
+            }
+
+            int status;
+            pid_t pid = waitpid(-1, &status, 0);
+            auto it = running.find(pid);
+            if (it == running.end())
+            {
+                continue;
+            }
+            bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            failures += ok ? 0 : 1;
+            std::cout << "  " << variants[it->second].name << (ok ? " done" : " FAILED") << " -> "
+                      << logPrefix << "-" << variants[it->second].name << ".log" << std::endl;
+            running.erase(it);
+        }
+        return failures;
+    }
+
+  private:
+    static void RunChild(const WarmupVariant& variant,
+                         const std::string& logPrefix,
+                         ApplyCallback apply,
+                         FinishCallback finish)
+    {
+        std::string log = logPrefix + "-" + variant.name + ".log";
+        int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+
+        apply(variant);
+        Simulator::Run();
+        int status = finish(variant);
+        Simulator::Destroy();
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        _exit(status);
+    }
+};
+
+} // namespace ns3
+
+#endif // WARMUP_FORK_H
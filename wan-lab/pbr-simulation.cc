@@ -0,0 +1,588 @@
+/*
+ * Exercice 5: Policy-Based Routing pour Application-Aware WAN Path Selection
+ * 
+ * MediaStream Inc. - Simulation NS-3
+ * Implémentation complète avec classification de trafic, PBR et contrôleur SD-WAN
+ * 
+ * Compilation (PathMetricsMonitor, PolicyBasedRouter et SdwanController sont
+ * dans scratch-wan-lab-lib, voir lib/sdwan-components.h) :
+ * ./ns3 build pbr-simulation
+ * 
+ * Exécution:
+ * ./ns3 run pbr-simulation
+ *
+ * Par défaut, le délai du lien primaire passe à 45 ms de 15 s à 22 s : la
+ * vidéo bascule sur le secondaire puis revient au primaire une fois ses
+ * métriques expirées (--staleAge) et le lien rétabli.
+ *
+ * Dégradations rejouées depuis une trace (liens "primary" et "secondary",
+ * voir impairment-trace-convert) au lieu de la dégradation intégrée :
+ * ./ns3 run "pbr-simulation --impairmentTrace=scratch/brownout.impt"
+ *
+ * Agrégation des deux liens WAN : flux DATA répartis par hachage pondéré,
+ * la vidéo reste épinglée par le contrôleur SD-WAN :
+ * ./ns3 run "pbr-simulation --multipath=1 --dataFlows=8"
+ *
+ * Variantes « what-if » après un préchauffage commun (voir lib/warmup-fork.h),
+ * clés threshold (ms), holdDown (s), impairment (trace) et multipath (0/1),
+ * résultats dans scratch/pbr-whatif-<variante>.log :
+ * ./ns3 run "pbr-simulation --warmup=10 --whatIf=threshold=20;threshold=40;impairment=scratch/cut.impt"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "lib/bench-report.h"
+#include "lib/event-log.h"
+#include "lib/link-impairment.h"
+#include "lib/metrics-exporter.h"
+#include "lib/pcap-ring.h"
+#include "lib/perf-counters.h"
+#include "lib/sdwan-components.h"
+#include "lib/warmup-fork.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("PbrSimulation");
+
+// ========================================
+// FONCTION: Validation
+// ========================================
+
+void ValidatePbrOperation(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier) {
+    std::cout << "\n========== VALIDATION PBR ==========\n";
+    
+    monitor->CheckForLostPackets();
+    std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
+    
+    double totalVideoLatency = 0.0;
+    double totalDataLatency = 0.0;
+    uint32_t videoFlows = 0;
+    uint32_t dataFlows = 0;
+    
+    for (auto const& flow : stats) {
+        Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow(flow.first);
+        
+        if (flow.second.rxPackets == 0) continue;
+        
+        double avgLatency = flow.second.delaySum.GetMilliSeconds() / flow.second.rxPackets;
+        double throughput = (flow.second.rxBytes * 8.0) / 
+                           (flow.second.timeLastRxPacket.GetSeconds() - 
+                            flow.second.timeFirstTxPacket.GetSeconds()) / 1e6;
+        double lossRate = (flow.second.lostPackets * 100.0) / flow.second.txPackets;
+        
+        std::cout << "\nFlux " << flow.first << ":\n";
+        std::cout << "  Type: " << (tuple.destinationPort == 5004 ? "VIDEO (RTP)" : "DATA (Bulk)") << "\n";
+        std::cout << "  " << tuple.sourceAddress << ":" << tuple.sourcePort << " -> "
+                 << tuple.destinationAddress << ":" << tuple.destinationPort << "\n";
+        std::cout << "  Paquets Tx/Rx: " << flow.second.txPackets << "/" << flow.second.rxPackets << "\n";
+        std::cout << "  Latence moyenne: " << avgLatency << " ms\n";
+        std::cout << "  Débit: " << throughput << " Mbps\n";
+        std::cout << "  Taux de perte: " << lossRate << " %\n";
+        
+        if (tuple.destinationPort == 5004) {
+            totalVideoLatency += avgLatency;
+            videoFlows++;
+        } else {
+            totalDataLatency += avgLatency;
+            dataFlows++;
+        }
+    }
+    
+    // Métriques globales
+    std::cout << "\n--- MÉTRIQUES GLOBALES ---\n";
+    if (videoFlows > 0) {
+        std::cout << "Latence moyenne VIDEO: " << (totalVideoLatency / videoFlows) << " ms\n";
+    }
+    if (dataFlows > 0) {
+        std::cout << "Latence moyenne DATA: " << (totalDataLatency / dataFlows) << " ms\n";
+    }
+    
+    std::cout << "=====================================\n";
+}
+
+// ========================================
+// FONCTION PRINCIPALE
+// ========================================
+
+// Capture PCAP autour de chaque basculement SD-WAN
+void TriggerCaptureOnSwitch(PcapRingCapture* ring, uint32_t tclass, uint32_t newInterface) {
+    std::ostringstream reason;
+    reason << "basculement SD-WAN classe " << tclass << " -> interface " << newInterface;
+    ring->Trigger(reason.str());
+}
+
+// Latence de basculement : dernière modification du lien primaire -> basculement suivant
+struct SwitchoverProbe {
+    Time lastImpairment = Seconds(-1);
+    std::vector<Time> latencies;
+};
+
+void RecordImpairment(SwitchoverProbe* probe, const std::string& link, const LinkImpairmentState& state) {
+    if (link == "primary") {
+        probe->lastImpairment = Simulator::Now();
+    }
+    std::cout << "\n🔧 [" << Simulator::Now().GetSeconds() << "s] Lien " << link << ": délai "
+              << state.delay.GetMilliSeconds() << " ms, perte " << state.loss * 100 << " %, débit "
+              << state.rate.GetBitRate() / 1e6 << " Mbps" << (state.up ? "" : ", coupé") << "\n";
+}
+
+void RecordSwitchover(SwitchoverProbe* probe, uint32_t tclass, uint32_t newInterface) {
+    if (probe->lastImpairment.IsNegative()) {
+        return;
+    }
+    probe->latencies.push_back(Simulator::Now() - probe->lastImpairment);
+    probe->lastImpairment = Seconds(-1);
+}
+
+// Une ligne par photographie : moyenne des sites chronométrés
+void PrintPerfSnapshot(const std::vector<PerfStats>& stats) {
+    std::cout << "[" << Simulator::Now().GetSeconds() << "s] perf:";
+    for (const PerfStats& s : stats) {
+        std::cout << " " << s.name << "=" << s.calls;
+        if (s.timed) {
+            std::cout << "x" << uint64_t(s.meanNs) << "ns";
+        }
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char *argv[]) {
+    
+    // Configuration des logs
+    LogComponentEnable("PbrSimulation", LOG_LEVEL_INFO);
+    LogComponentEnable("SdwanComponents", LOG_LEVEL_INFO);
+    LogComponentEnable("PcapRingCapture", LOG_LEVEL_INFO);
+    
+    // Paramètres de simulation
+    double simulationTime = 30.0; // secondes
+    uint32_t videoPacketSize = 160; // bytes
+    uint32_t dataPacketSize = 1460; // bytes
+    double videoInterval = 0.02; // 20ms (50 paquets/sec)
+    std::string exportFile = "";        // Vide = pas d'export de séries temporelles
+    std::string exportFormat = "rows";
+    double exportInterval = 0.1; // secondes
+    std::string eventLog = "";          // Vide = bannières console, pas de journal
+    bool perfReport = false;
+    double perfInterval = 0.0;          // secondes, 0 = pas de photographie
+    std::string pcapMode = "full";      // full: toute la simulation, ring: autour des basculements
+    double pcapWindow = 2.0; // secondes conservées avant et après un basculement
+    uint32_t pcapMaxBytes = 4 * 1024 * 1024;
+    uint32_t pcapSample = 1;
+    std::string impairmentTrace = "";   // Vide = dégradation intégrée du lien primaire (15-22 s)
+    double staleAge = 3.0;              // secondes, 0 = métriques jamais expirées (pas de retour)
+    bool multipath = false;             // DATA réparti sur les liens primaire et secondaire
+    uint32_t dataFlows = 1;             // Transferts TCP parallèles
+    std::string whatIf = "";            // Variantes après préchauffage (vide = exécution simple)
+    double warmup = 10.0;               // secondes
+    uint32_t jobs = 0;                  // 0 = nombre de cœurs
+    std::string whatIfPrefix = "scratch/pbr-whatif";
+    
+    CommandLine cmd;
+    cmd.AddValue("simulationTime", "Durée simulée (s)", simulationTime);
+    cmd.AddValue("exportFile", "Fichier de séries temporelles des chemins (vide = aucun)", exportFile);
+    cmd.AddValue("exportFormat", "Format d'export: rows, columns ou csv", exportFormat);
+    cmd.AddValue("exportInterval", "Période d'échantillonnage de l'export (s)", exportInterval);
+    cmd.AddValue("eventLog", "Journal d'évènements binaire (voir event-log-print, vide = aucun)", eventLog);
+    cmd.AddValue("perfReport", "Rapport d'instrumentation des chemins chauds à la fin", perfReport);
+    cmd.AddValue("perfInterval", "Période des photographies d'instrumentation (s, 0 = aucune)", perfInterval);
+    cmd.AddValue("pcapMode", "Capture PCAP: full, ring (autour des basculements) ou none", pcapMode);
+    cmd.AddValue("pcapWindow", "Mode ring: secondes conservées avant et après un basculement", pcapWindow);
+    cmd.AddValue("pcapMaxBytes", "Mode ring: octets conservés par interface", pcapMaxBytes);
+    cmd.AddValue("pcapSample", "Capturer 1 flux sur K", pcapSample);
+    cmd.AddValue("multipath", "Répartir le trafic DATA sur les deux liens WAN", multipath);
+    cmd.AddValue("dataFlows", "Nombre de transferts TCP parallèles", dataFlows);
+    cmd.AddValue("whatIf", "Variantes après préchauffage: clé=valeur,...;... (threshold, holdDown, impairment, multipath)", whatIf);
+    cmd.AddValue("warmup", "Mode what-if: durée du préchauffage commun (s)", warmup);
+    cmd.AddValue("jobs", "Mode what-if: processus simultanés (0 = nombre de cœurs)", jobs);
+    cmd.AddValue("whatIfPrefix", "Mode what-if: préfixe des journaux par variante", whatIfPrefix);
+    cmd.AddValue("impairmentTrace", "Trace de dégradations des liens primary et secondary (vide = dégradation de 15 à 22 s)", impairmentTrace);
+    cmd.AddValue("staleAge", "Expiration des métriques d'un chemin sans trafic, pour le retour au primaire (s, 0 = jamais)", staleAge);
+    cmd.Parse(argc, argv);
+    
+    // Les fichiers ouverts avant le fork seraient partagés par toutes les
+    // variantes : chacune n'écrit que son journal
+    std::vector<WarmupVariant> variants = WarmupFork::ParseVariants(whatIf);
+    for (const WarmupVariant& variant : variants) {
+        std::string unknown = variant.FindUnknownKey({"threshold", "holdDown", "impairment", "multipath"});
+        if (!unknown.empty()) {
+            NS_FATAL_ERROR("Clé de variante inconnue: " << unknown);
+        }
+    }
+    if (!variants.empty()) {
+        if (warmup <= 0 || warmup >= simulationTime) {
+            NS_FATAL_ERROR("Le préchauffage doit être dans ]0, " << simulationTime << "[ s");
+        }
+        exportFile = "";
+        eventLog = "";
+        pcapMode = "none";
+    }
+    
+    std::cout << "\n╔════════════════════════════════════════════════════╗\n";
+    std::cout << "║   SIMULATION NS-3: Policy-Based Routing (PBR)    ║\n";
+    std::cout << "║          MediaStream Inc. - WAN Simulation         ║\n";
+    std::cout << "╚════════════════════════════════════════════════════╝\n\n";
+    
+    // ========================================
+    // CRÉATION DE LA TOPOLOGIE
+    // ========================================
+    
+    NS_LOG_INFO("Création des nœuds...");
+    NodeContainer nodes;
+    nodes.Create(4); // Studio, Router, Cloud, Router2
+    
+    Ptr<Node> studioNode = nodes.Get(0);
+    Ptr<Node> routerNode = nodes.Get(1);
+    Ptr<Node> cloudNode = nodes.Get(2);
+    Ptr<Node> router2Node = nodes.Get(3);
+    
+    // ========================================
+    // CONFIGURATION DES LIENS
+    // ========================================
+    
+    NS_LOG_INFO("Configuration des liens Point-to-Point...");
+    
+    PointToPointHelper p2pStudioRouter;
+    p2pStudioRouter.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    p2pStudioRouter.SetChannelAttribute("Delay", StringValue("5ms"));
+    
+    // Lien primaire (faible latence, bande passante moyenne)
+    PointToPointHelper p2pPrimary;
+    p2pPrimary.SetDeviceAttribute("DataRate", StringValue("50Mbps"));
+    p2pPrimary.SetChannelAttribute("Delay", StringValue("10ms"));
+    
+    // Lien secondaire (latence plus élevée, haute bande passante)
+    PointToPointHelper p2pSecondary;
+    p2pSecondary.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    p2pSecondary.SetChannelAttribute("Delay", StringValue("25ms"));
+    
+    // Installation des liens
+    NetDeviceContainer devicesStudioRouter = p2pStudioRouter.Install(studioNode, routerNode);
+    NetDeviceContainer devicesPrimary = p2pPrimary.Install(routerNode, cloudNode);
+    NetDeviceContainer devicesSecondary = p2pSecondary.Install(router2Node, cloudNode);
+    NetDeviceContainer devicesRouterRouter2 = p2pSecondary.Install(routerNode, router2Node);
+    
+    // ========================================
+    // INSTALLATION DE LA PILE INTERNET
+    // ========================================
+    
+    NS_LOG_INFO("Installation de la pile Internet...");
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    
+    // Attribution des adresses IP
+    Ipv4AddressHelper address;
+    
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesStudioRouter = address.Assign(devicesStudioRouter);
+    
+    address.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesPrimary = address.Assign(devicesPrimary);
+    
+    address.SetBase("10.1.3.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesRouterRouter2 = address.Assign(devicesRouterRouter2);
+    
+    address.SetBase("10.1.4.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesSecondary = address.Assign(devicesSecondary);
+    
+    // ========================================
+    // CONFIGURATION DU ROUTAGE
+    // ========================================
+    
+    NS_LOG_INFO("Configuration du routage global...");
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    
+    // ========================================
+    // APPLICATION: FLOW_VIDEO (RTP-like)
+    // ========================================
+    
+    NS_LOG_INFO("Configuration Flow_Video (RTP)...");
+    uint16_t videoPort = 5004;
+    
+    UdpServerHelper videoServer(videoPort);
+    ApplicationContainer videoServerApp = videoServer.Install(cloudNode);
+    videoServerApp.Start(Seconds(1.0));
+    videoServerApp.Stop(Seconds(simulationTime));
+    
+    UdpClientHelper videoClient(interfacesPrimary.GetAddress(1), videoPort);
+    videoClient.SetAttribute("MaxPackets", UintegerValue(100000));
+    videoClient.SetAttribute("Interval", TimeValue(MilliSeconds(20)));
+    videoClient.SetAttribute("PacketSize", UintegerValue(videoPacketSize));
+    
+    ApplicationContainer videoClientApp = videoClient.Install(studioNode);
+    videoClientApp.Start(Seconds(2.0));
+    videoClientApp.Stop(Seconds(simulationTime));
+    
+    // ========================================
+    // APPLICATION: FLOW_DATA (FTP-like)
+    // ========================================
+    
+    NS_LOG_INFO("Configuration Flow_Data (Bulk Transfer)...");
+    uint16_t dataPort = 9;
+    
+    PacketSinkHelper dataSink("ns3::TcpSocketFactory",
+                              InetSocketAddress(Ipv4Address::GetAny(), dataPort));
+    ApplicationContainer dataSinkApp = dataSink.Install(cloudNode);
+    dataSinkApp.Start(Seconds(1.0));
+    dataSinkApp.Stop(Seconds(simulationTime));
+    
+    BulkSendHelper dataSource("ns3::TcpSocketFactory",
+                              InetSocketAddress(interfacesPrimary.GetAddress(1), dataPort));
+    dataSource.SetAttribute("MaxBytes", UintegerValue(50000000)); // 50 MB
+    dataSource.SetAttribute("SendSize", UintegerValue(dataPacketSize));
+    
+    // Un port source par transfert : autant de 5-tuples à répartir
+    ApplicationContainer dataSourceApp;
+    for (uint32_t f = 0; f < dataFlows; f++) {
+        dataSourceApp.Add(dataSource.Install(studioNode));
+    }
+    dataSourceApp.Start(Seconds(2.5));
+    dataSourceApp.Stop(Seconds(simulationTime));
+    
+    // ========================================
+    // INSTALLATION DU FLOW MONITOR
+    // ========================================
+    
+    NS_LOG_INFO("Installation du FlowMonitor...");
+    FlowMonitorHelper flowmonHelper;
+    Ptr<FlowMonitor> flowMonitor = flowmonHelper.InstallAll();
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+    
+    // ========================================
+    // CRÉATION DES COMPOSANTS PBR
+    // ========================================
+    
+    NS_LOG_INFO("Initialisation des composants PBR...");
+    
+    // PathMetricsMonitor
+    Ptr<PathMetricsMonitor> metricsMonitor = CreateObject<PathMetricsMonitor>();
+    metricsMonitor->SetAttribute("StaleAge", TimeValue(Seconds(staleAge)));
+    metricsMonitor->Initialize();
+    metricsMonitor->EnableLatencyTracking(routerNode);
+    metricsMonitor->EnableReceiveTracking(cloudNode);
+    Simulator::Schedule(Seconds(2.0), &PathMetricsMonitor::UpdateBandwidthMetrics, metricsMonitor);
+    
+    if (!eventLog.empty() && !EventLog::Get().Open(eventLog)) {
+        NS_FATAL_ERROR("Impossible d'ouvrir " << eventLog);
+    }
+    
+    MetricsExporter exporter;
+    ExportFormat format = EXPORT_ROWS;
+    if (!exportFile.empty()) {
+        if (!ParseExportFormat(exportFormat, format)) {
+            NS_FATAL_ERROR("Format d'export inconnu: " << exportFormat);
+        }
+        if (!exporter.Open(exportFile, format)) {
+            NS_FATAL_ERROR("Impossible d'ouvrir " << exportFile);
+        }
+        metricsMonitor->StartExport(&exporter, Seconds(exportInterval));
+    }
+    
+    // Interfaces du routeur (l'interface 0 est la boucle locale)
+    Ptr<Ipv4> routerIpv4 = routerNode->GetObject<Ipv4>();
+    uint32_t lanIf = routerIpv4->GetInterfaceForDevice(devicesStudioRouter.Get(1));
+    uint32_t primaryIf = routerIpv4->GetInterfaceForDevice(devicesPrimary.Get(0));
+    uint32_t secondaryIf = routerIpv4->GetInterfaceForDevice(devicesRouterRouter2.Get(0));
+    
+    // Le chemin secondaire (via Router2) doit atteindre le Cloud par le lien
+    // 10.1.4.0/24 et non revenir vers le routeur principal
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    Ptr<Ipv4> router2Ipv4 = router2Node->GetObject<Ipv4>();
+    staticRoutingHelper.GetStaticRouting(router2Ipv4)->AddHostRouteTo(
+        interfacesPrimary.GetAddress(1),
+        interfacesSecondary.GetAddress(1),
+        router2Ipv4->GetInterfaceForDevice(devicesSecondary.Get(0)));
+    
+    // PolicyBasedRouter : protocole de routage au-dessus du routage global
+    Ptr<PolicyBasedRouter> pbr = CreateObject<PolicyBasedRouter>();
+    pbr->AddSteeredIngress(lanIf);
+    pbr->UpdateClassInterface(DATA_TRAFFIC, secondaryIf);
+    pbr->Install(routerNode);
+    if (multipath) {
+        pbr->AddMultipathInterface(primaryIf);
+        pbr->AddMultipathInterface(secondaryIf);
+        pbr->SetClassMultipath(DATA_TRAFFIC, true);
+        pbr->EnableMultipath(metricsMonitor);
+    }
+    
+    // SdwanController
+    Ptr<SdwanController> sdwanController = CreateObject<SdwanController>();
+    sdwanController->SetAttribute("EventDriven", BooleanValue(true));
+    sdwanController->SetAttribute("HoldDown", TimeValue(Seconds(2.0)));
+    sdwanController->SetRouter(routerNode);
+    sdwanController->SetMetricsMonitor(metricsMonitor);
+    sdwanController->SetPbr(pbr);
+    
+    // Ajouter la politique pour le trafic vidéo
+    uint32_t videoPolicy = sdwanController->AddPolicy(VIDEO_TRAFFIC, 30.0, primaryIf, secondaryIf);
+    sdwanController->Start();
+    
+    // ========================================
+    // SIMULATION D'UNE DÉGRADATION DU LIEN
+    // ========================================
+    
+    // Trace de dégradations, ou par défaut le délai du lien primaire porté
+    // à 45 ms de t=15s à t=22s (au-dessus du seuil vidéo de 30 ms) pour
+    // tester le basculement puis le retour au primaire
+    LinkImpairmentEngine impairments;
+    impairments.AddLink("primary", devicesPrimary);
+    impairments.AddLink("secondary", devicesSecondary);
+    if (!impairmentTrace.empty()) {
+        if (!impairments.Load(impairmentTrace)) {
+            NS_FATAL_ERROR(impairments.GetError());
+        }
+    } else {
+        link_impairment::Trace degradation;
+        link_impairment::Change change = {};
+        change.time = Seconds(15.0).GetNanoSeconds();
+        change.link = degradation.AddLink("primary");
+        change.mask = link_impairment::FIELD_DELAY;
+        change.delay = MilliSeconds(45).GetNanoSeconds();
+        degradation.AddChange(change);
+        change.time = Seconds(22.0).GetNanoSeconds();
+        change.delay = MilliSeconds(10).GetNanoSeconds();
+        degradation.AddChange(change);
+        impairments.SetTrace(degradation);
+    }
+    
+    SwitchoverProbe switchover;
+    impairments.SetChangeCallback([&switchover](const std::string& link, uint8_t, const LinkImpairmentState& state) {
+        RecordImpairment(&switchover, link, state);
+    });
+    sdwanController->TraceConnectWithoutContext("Switch",
+        MakeBoundCallback(&RecordSwitchover, &switchover));
+    impairments.Start();
+    
+    // ========================================
+    // ACTIVATION DES TRACES PCAP
+    // ========================================
+    
+    // Mode ring: lien studio et liens WAN du routeur gardés en mémoire,
+    // écrits sur disque uniquement autour d'un basculement
+    PcapRingCapture pcapRing("scratch/pbr-switchover");
+    if (pcapMode == "ring") {
+        NS_LOG_INFO("Activation de la capture PCAP sur basculement...");
+        pcapRing.SetWindow(Seconds(pcapWindow), pcapMaxBytes);
+        pcapRing.SetPostTrigger(Seconds(pcapWindow));
+        pcapRing.SetSampling(pcapSample);
+        pcapRing.Install(devicesStudioRouter);
+        pcapRing.Install(devicesPrimary.Get(0));
+        pcapRing.Install(devicesRouterRouter2.Get(0));
+        sdwanController->TraceConnectWithoutContext("Switch",
+            MakeBoundCallback(&TriggerCaptureOnSwitch, &pcapRing));
+    } else if (pcapMode == "full") {
+        NS_LOG_INFO("Activation des traces PCAP...");
+        p2pStudioRouter.EnablePcap("scratch/pbr-studio-link", devicesStudioRouter);
+    } else if (pcapMode != "none") {
+        NS_FATAL_ERROR("Mode PCAP inconnu: " << pcapMode);
+    }
+    
+    // ========================================
+    // EXÉCUTION
+    // ========================================
+    
+    if (perfReport) {
+        PerfRegistry::Get().ReportAtDestroy();
+    }
+    if (perfInterval > 0) {
+        PerfRegistry::Get().StartSnapshots(Seconds(perfInterval), PrintPerfSnapshot);
+    }
+    
+    // ========================================
+    // RÉSULTATS
+    // ========================================
+    
+    auto printResults = [&]() {
+        metricsMonitor->PrintMetrics();
+        ValidatePbrOperation(flowMonitor, classifier);
+        pbr->PrintFlowCacheStats();
+        pbr->PrintMultipathStats();
+        std::cout << "\nNombre de basculements SD-WAN: " << sdwanController->GetSwitchCount() << "\n";
+        std::cout << "Dégradations appliquées: " << impairments.GetChangesApplied() << "/"
+                  << impairments.GetNChanges() << "\n";
+        for (const Time& latency : switchover.latencies) {
+            std::cout << "Latence de basculement: " << latency.GetMilliSeconds() << " ms\n";
+        }
+        if (switchover.latencies.empty() && impairments.GetChangesApplied() > 0) {
+            std::cout << "Aucun basculement après une dégradation du lien primaire\n";
+        }
+        if (pcapMode == "ring") {
+            std::cout << "Capture PCAP: " << pcapRing.GetTriggers() << " déclenchement(s), "
+                      << pcapRing.GetPacketsWritten() << "/" << pcapRing.GetPacketsSeen()
+                      << " paquets écrits -> scratch/pbr-switchover-*.pcap\n";
+        }
+    };
+    
+    std::cout << "🚀 Démarrage de la simulation (" << simulationTime << " s)...\n\n";
+    Simulator::Stop(Seconds(simulationTime));
+    
+    if (!variants.empty()) {
+        // Chaque variante reprend l'état du préchauffage et ne modifie que
+        // les paramètres qu'elle nomme
+        uint32_t failures = WarmupFork::Run(Seconds(warmup), variants, jobs, whatIfPrefix,
+            [&](const WarmupVariant& variant) {
+                std::cout << "Variante " << variant.name << " à t=" << warmup << " s\n";
+                if (variant.Has("threshold")) {
+                    sdwanController->SetLatencyThreshold(videoPolicy, variant.GetDouble("threshold", 30.0));
+                }
+                if (variant.Has("holdDown")) {
+                    sdwanController->SetAttribute("HoldDown",
+                        TimeValue(Seconds(variant.GetDouble("holdDown", 2.0))));
+                }
+                if (variant.Has("impairment")) {
+                    // Temps de simulation absolus ; une trace vide retire la dégradation prévue
+                    std::string trace = variant.Get("impairment");
+                    bool loaded = trace.empty() ? impairments.SetTrace(link_impairment::Trace())
+                                                : impairments.Load(trace);
+                    if (!loaded) {
+                        NS_FATAL_ERROR(impairments.GetError());
+                    }
+                    impairments.Start();
+                }
+                if (variant.Has("multipath")) {
+                    bool enable = variant.Get("multipath") != "0";
+                    if (enable && !multipath) {
+                        pbr->AddMultipathInterface(primaryIf);
+                        pbr->AddMultipathInterface(secondaryIf);
+                        pbr->EnableMultipath(metricsMonitor);
+                    }
+                    pbr->SetClassMultipath(DATA_TRAFFIC, enable);
+                }
+            },
+            [&](const WarmupVariant&) {
+                printResults();
+                return 0;
+            });
+        Simulator::Destroy();
+        return failures > 0 ? 1 : 0;
+    }
+    
+    BenchReport::Arm();
+    Simulator::Run();
+    printResults();
+    
+    exporter.Close();
+    if (!exportFile.empty()) {
+        std::cout << "Séries temporelles: " << exporter.GetRecordsWritten()
+                  << " enregistrements -> " << exportFile << "\n";
+    }
+    if (EventLog::Get().IsOpen()) {
+        std::cout << "Journal d'évènements: " << EventLog::Get().GetRecordsWritten()
+                  << " enregistrements -> " << eventLog << "\n";
+        EventLog::Get().Close();
+    }
+    
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,612 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/traffic-control-module.h"
+#include "lib/bench-report.h"
+#include "lib/event-log.h"
+#include "lib/link-impairment.h"
+#include "lib/metrics-exporter.h"
+#include "lib/perf-counters.h"
+#include "lib/qos-traffic.h"
+#include "lib/warmup-fork.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("QoSMixedTraffic");
+
+// ========== SCÉNARIO ==========
+
+// Paramètres d'une exécution du scénario (un point du balayage)
+struct ScenarioConfig {
+    bool enableQos;
+    bool enableCongestion;
+    uint32_t voipClients;
+    uint32_t ftpClients;
+    std::string voipCodec;
+    bool callGroup;
+    bool ftpPacing;
+    bool onlineMetrics;
+    double sampleInterval;
+    std::string exportFile;
+    std::string exportFormat;
+    double exportInterval;
+    std::string eventLog;
+    bool perfReport;
+    double startJitter;         // Décalage aléatoire des démarrages (s), tiré du RngRun
+    std::string whatIf;         // Variantes après préchauffage (voir lib/warmup-fork.h)
+    double warmup;
+    uint32_t jobs;
+    std::string whatIfPrefix;
+    
+    ScenarioConfig() : enableQos(true), enableCongestion(true), voipClients(5),
+        ftpClients(3), voipCodec("G711"), callGroup(false), ftpPacing(false),
+        onlineMetrics(false), sampleInterval(5.0), exportFile(""),
+        exportFormat("rows"), exportInterval(0.1), eventLog(""), perfReport(false),
+        startJitter(0.5), whatIf(""), warmup(10.0), jobs(0), whatIfPrefix("qos-whatif") {}
+};
+
+// Priorité socket -> bande : celle de pfifo_fast, ou tout en bande 0 (sans QoS)
+const char* QOS_PRIOMAP = "1 2 2 2 1 2 0 0 1 1 1 1 1 1 1 1";
+const char* FIFO_PRIOMAP = "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0";
+
+// Construit la topologie, exécute la simulation et remplit le collecteur.
+// En mode what-if, retourne le nombre de variantes en échec.
+int RunScenario(const ScenarioConfig& config, QosMetricsCollector& collector) {
+    NS_LOG_UNCOND("\n╔════════════════════════════════════════════════════════════════╗");
+    NS_LOG_UNCOND("║     SIMULATION QoS - TRAFIC MIXTE VoIP & FTP                  ║");
+    NS_LOG_UNCOND("╠════════════════════════════════════════════════════════════════╣");
+    NS_LOG_UNCOND("║  QoS activée         : " << (config.enableQos ? "OUI" : "NON"));
+    NS_LOG_UNCOND("║  Congestion          : " << (config.enableCongestion ? "OUI" : "NON"));
+    NS_LOG_UNCOND("║  Clients VoIP        : " << config.voipClients);
+    NS_LOG_UNCOND("║  Clients FTP         : " << config.ftpClients);
+    NS_LOG_UNCOND("╚════════════════════════════════════════════════════════════════╝\n");
+    
+    // ========== CRÉATION DE LA TOPOLOGIE ==========
+    
+    NodeContainer nodes;
+    nodes.Create(3); // 0=Client, 1=Router, 2=Server
+    
+    // Configuration du lien avec bande passante limitée
+    PointToPointHelper p2pClientRouter;
+    p2pClientRouter.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    p2pClientRouter.SetChannelAttribute("Delay", StringValue("2ms"));
+    
+    PointToPointHelper p2pRouterServer;
+    // QUESTION 4: Lien WAN avec bande passante limitée pour créer congestion
+    p2pRouterServer.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+    p2pRouterServer.SetChannelAttribute("Delay", StringValue("20ms"));
+    
+    NetDeviceContainer devicesClientRouter = p2pClientRouter.Install(nodes.Get(0), nodes.Get(1));
+    NetDeviceContainer devicesRouterServer = p2pRouterServer.Install(nodes.Get(1), nodes.Get(2));
+    
+    // ========== QUESTION 2: CONFIGURATION QoS ==========
+    
+    TrafficControlHelper tch;
+    std::vector<WarmupVariant> variants = WarmupFork::ParseVariants(config.whatIf);
+    Ptr<QueueDisc> wanQueueDisc;
+    
+    if (!variants.empty()) {
+        // Mode what-if : la QoS doit pouvoir basculer après le préchauffage.
+        // PrioQueueDisc à trois bandes FIFO, la Priomap décide : celle de
+        // pfifo_fast (QoS) ou une seule bande (sans QoS)
+        uint16_t handle = tch.SetRootQueueDisc("ns3::PrioQueueDisc", "Priomap",
+            StringValue(config.enableQos ? QOS_PRIOMAP : FIFO_PRIOMAP));
+        TrafficControlHelper::ClassIdList classes = tch.AddQueueDiscClasses(handle, 3, "ns3::QueueDiscClass");
+        tch.AddChildQueueDiscs(handle, classes, "ns3::FifoQueueDisc", "MaxSize", StringValue("1000p"));
+        wanQueueDisc = tch.Install(devicesRouterServer.Get(0)).Get(0);
+    } else if (config.enableQos) {
+        NS_LOG_INFO("Configuration de la discipline de file d'attente prioritaire...");
+        
+        // Utilisation de PfifoFastQueueDisc (3 bandes de priorité)
+        tch.SetRootQueueDisc("ns3::PfifoFastQueueDisc",
+                             "MaxSize", StringValue("1000p"));
+        
+        // Installation sur l'interface du routeur vers le serveur
+        QueueDiscContainer qdiscs = tch.Install(devicesRouterServer.Get(0));
+        
+        NS_LOG_INFO("✓ QoS configurée: PfifoFastQueueDisc avec 3 niveaux de priorité");
+        NS_LOG_INFO("  • Bande 0 (haute priorité): TOS bits [0-3] - VoIP (DSCP EF)");
+        NS_LOG_INFO("  • Bande 1 (priorité moyenne): TOS bits [4-7]");
+        NS_LOG_INFO("  • Bande 2 (basse priorité): TOS bits [8-15] - FTP (DSCP BE)");
+    }
+    
+    // Installation de la pile Internet
+    InternetStackHelper stack;
+    stack.Install(nodes);
+    
+    // Attribution des adresses IP
+    Ipv4AddressHelper address;
+    
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer ifacesClientRouter = address.Assign(devicesClientRouter);
+    
+    address.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer ifacesRouterServer = address.Assign(devicesRouterServer);
+    
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    
+    // ========== CONFIGURATION DES APPLICATIONS ==========
+    
+    // Serveur VoIP sur le serveur (port 5060)
+    uint16_t voipPort = 5060;
+    PacketSinkHelper voipSink("ns3::UdpSocketFactory",
+                              InetSocketAddress(Ipv4Address::GetAny(), voipPort));
+    ApplicationContainer voipServerApp = voipSink.Install(nodes.Get(2));
+    voipServerApp.Start(Seconds(1.0));
+    voipServerApp.Stop(Seconds(30.0));
+    
+    // Serveur FTP sur le serveur (port 21)
+    uint16_t ftpPort = 21;
+    PacketSinkHelper ftpSink("ns3::UdpSocketFactory",
+                             InetSocketAddress(Ipv4Address::GetAny(), ftpPort));
+    ApplicationContainer ftpServerApp = ftpSink.Install(nodes.Get(2));
+    ftpServerApp.Start(Seconds(1.0));
+    ftpServerApp.Stop(Seconds(30.0));
+    
+    // Chaque client démarre avec un décalage uniforme dans [0, startJitter] :
+    // les réplications du balayage (RngRun différents) ne sont pas identiques
+    Ptr<UniformRandomVariable> startOffset = CreateObject<UniformRandomVariable>();
+    startOffset->SetAttribute("Max", DoubleValue(config.startJitter));
+    
+    // Création de plusieurs clients VoIP
+    if (config.callGroup) {
+        // Un seul groupe : voipClients appels, une socket, un évènement en file
+        Ptr<VoipCallGroup> group = CreateObject<VoipCallGroup>();
+        group->SetAttribute("NumCalls", UintegerValue(config.voipClients));
+        group->SetAttribute("Codec", StringValue(config.voipCodec));
+        group->AddDestination(ifacesRouterServer.GetAddress(1), voipPort);
+        nodes.Get(0)->AddApplication(group);
+        group->SetStartTime(Seconds(2.0));
+        group->SetStopTime(Seconds(30.0));
+    }
+    for (uint32_t i = 0; !config.callGroup && i < config.voipClients; i++) {
+        Ptr<VoipTrafficGenerator> voipApp = CreateObject<VoipTrafficGenerator>();
+        voipApp->SetAttribute("Codec", StringValue(config.voipCodec));
+        voipApp->Setup(ifacesRouterServer.GetAddress(1), voipPort);
+        nodes.Get(0)->AddApplication(voipApp);
+        voipApp->SetStartTime(Seconds(2.0 + i * 0.1 + startOffset->GetValue()));
+        voipApp->SetStopTime(Seconds(30.0));
+    }
+    
+    // Création de plusieurs clients FTP
+    for (uint32_t i = 0; i < config.ftpClients; i++) {
+        Ptr<FtpTrafficGenerator> ftpApp = CreateObject<FtpTrafficGenerator>();
+        ftpApp->SetAttribute("Pacing", BooleanValue(config.ftpPacing));
+        ftpApp->Setup(ifacesRouterServer.GetAddress(1), ftpPort);
+        nodes.Get(0)->AddApplication(ftpApp);
+        
+        if (config.enableCongestion) {
+            // Démarrage échelonné pour créer congestion progressive
+            ftpApp->SetStartTime(Seconds(5.0 + i * 2.0 + startOffset->GetValue()));
+        } else {
+            ftpApp->SetStartTime(Seconds(2.5 + i * 0.1 + startOffset->GetValue()));
+        }
+        ftpApp->SetStopTime(Seconds(30.0));
+    }
+    
+    // ========== MONITORING ==========
+    
+    MetricsExporter exporter;
+    FlowMonitorHelper flowmon;
+    Ptr<FlowMonitor> monitor;
+    
+    if (config.onlineMetrics) {
+        collector.EnableOnline(nodes.Get(0), nodes.Get(2));
+        if (config.sampleInterval > 0) {
+            collector.StartSampling(Seconds(config.sampleInterval));
+        }
+        if (!config.exportFile.empty()) {
+            ExportFormat format = EXPORT_ROWS;
+            if (!ParseExportFormat(config.exportFormat, format)) {
+                NS_FATAL_ERROR("Format d'export inconnu: " << config.exportFormat);
+            }
+            if (!exporter.Open(config.exportFile, format)) {
+                NS_FATAL_ERROR("Impossible d'ouvrir " << config.exportFile);
+            }
+            collector.StartExport(&exporter, Seconds(config.exportInterval));
+        }
+    } else {
+        monitor = flowmon.InstallAll();
+    }
+    
+    if (config.perfReport) {
+        PerfRegistry::Get().ReportAtDestroy();
+    }
+    if (!config.eventLog.empty() && !EventLog::Get().Open(config.eventLog)) {
+        NS_FATAL_ERROR("Impossible d'ouvrir " << config.eventLog);
+    }
+    
+    // ========== EXÉCUTION ==========
+    
+    NS_LOG_UNCOND("\n🚀 Démarrage de la simulation...\n");
+    
+    // ========== ANALYSE DES RÉSULTATS ==========
+    
+    auto collectResults = [&]() {
+        NS_LOG_UNCOND("\n📈 Analyse des résultats...\n");
+        
+        if (!config.onlineMetrics) {
+            monitor->CheckForLostPackets();
+            Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+            std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats();
+            
+            for (auto const& stat : stats) {
+                Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(stat.first);
+                collector.RecordFlow(stat.first, stat.second, t);
+            }
+        }
+    };
+    
+    Simulator::Stop(Seconds(30.0));
+    
+    if (!variants.empty()) {
+        // Chaque variante reprend l'état du préchauffage (files, fenêtres,
+        // générateurs déjà démarrés) et écrit ses propres métriques
+        LinkImpairmentEngine impairments;
+        impairments.AddLink("wan", devicesRouterServer);
+        uint32_t failures = WarmupFork::Run(Seconds(config.warmup), variants, config.jobs,
+            config.whatIfPrefix,
+            [&](const WarmupVariant& variant) {
+                NS_LOG_UNCOND("Variante " << variant.name << " à t=" << config.warmup << " s");
+                if (variant.Has("qos")) {
+                    bool qos = variant.Get("qos") != "0";
+                    wanQueueDisc->SetAttribute("Priomap", StringValue(qos ? QOS_PRIOMAP : FIFO_PRIOMAP));
+                }
+                if (variant.Has("impairment")) {
+                    // Temps de simulation absolus, lien "wan" (routeur - serveur)
+                    if (!impairments.Load(variant.Get("impairment"))) {
+                        NS_FATAL_ERROR(impairments.GetError());
+                    }
+                    impairments.Start();
+                }
+            },
+            [&](const WarmupVariant& variant) {
+                collectResults();
+                collector.PrintReport();
+                collector.ExportToCsv(config.whatIfPrefix + "-" + variant.name + ".csv");
+                return 0;
+            });
+        Simulator::Destroy();
+        return failures;
+    }
+    
+    BenchReport::Arm();
+    Simulator::Run();
+    collectResults();
+    
+    exporter.Close();
+    if (EventLog::Get().IsOpen()) {
+        NS_LOG_UNCOND("Journal d'évènements: " << EventLog::Get().GetRecordsWritten()
+                      << " enregistrements -> " << config.eventLog);
+        EventLog::Get().Close();
+    }
+    Simulator::Destroy();
+    return 0;
+}
+
+// ========== BALAYAGE DE PARAMÈTRES ==========
+
+// Résultat d'une classe pour une exécution, transmis du processus fils au
+// parent par un tube sous forme d'enregistrement binaire à taille fixe
+struct SweepSample {
+    uint32_t point;
+    uint32_t qosClass;
+    uint32_t valid;
+    double lossRate;
+    double avgDelay;
+    double avgJitter;
+    double throughput;
+};
+
+// Échantillons d'une classe pour un point du balayage (une valeur par réplication)
+struct SweepAccumulator {
+    std::vector<double> lossRate;
+    std::vector<double> avgDelay;
+    std::vector<double> avgJitter;
+    std::vector<double> throughput;
+};
+
+std::vector<uint32_t> ParseUintList(const std::string& list) {
+    std::vector<uint32_t> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::stoul(item));
+        }
+    }
+    return values;
+}
+
+// Moyenne et demi-largeur de l'intervalle de confiance à 95 % (Student)
+double ConfidenceHalfWidth(const std::vector<double>& values, double& mean) {
+    static const double T_975[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365,
+                                   2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145,
+                                   2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080,
+                                   2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048,
+                                   2.045, 2.042};
+    uint32_t n = values.size();
+    mean = 0.0;
+    for (double v : values) {
+        mean += v;
+    }
+    mean = (n > 0) ? mean / n : 0.0;
+    if (n < 2) return 0.0;
+    
+    double variance = 0.0;
+    for (double v : values) {
+        variance += (v - mean) * (v - mean);
+    }
+    variance /= (n - 1);
+    double t = (n - 1 <= 30) ? T_975[n - 2] : 1.96;
+    return t * std::sqrt(variance / n);
+}
+
+// Processus fils : une exécution isolée du simulateur, résultats dans le tube
+void RunSweepChild(const ScenarioConfig& config, uint32_t point, uint32_t replication,
+                   int writeFd) {
+    int devnull = open("/dev/null", O_WRONLY);
+    dup2(devnull, STDOUT_FILENO);
+    dup2(devnull, STDERR_FILENO);
+    
+    RngSeedManager::SetRun(replication + 1);
+    QosMetricsCollector collector;
+    RunScenario(config, collector);
+    
+    for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+        QosMetricsCollector::DerivedMetrics d = collector.GetDerivedMetrics(QosClass(c));
+        SweepSample sample;
+        sample.point = point;
+        sample.qosClass = c;
+        sample.valid = collector.GetClassMetrics(QosClass(c)).txPackets > 0;
+        sample.lossRate = d.lossRate;
+        sample.avgDelay = d.avgDelay;
+        sample.avgJitter = d.avgJitter;
+        sample.throughput = d.throughput;
+        if (write(writeFd, &sample, sizeof(sample)) != sizeof(sample)) {
+            _exit(1);
+        }
+    }
+    close(writeFd);
+    _exit(0);
+}
+
+// Exécute chaque point de la grille replications fois, au plus jobs processus
+// en parallèle (le simulateur est un singleton : un processus par exécution),
+// puis fusionne les résultats en un tableau avec intervalles de confiance
+int RunSweep(const std::vector<ScenarioConfig>& points, uint32_t replications, uint32_t jobs,
+             const std::string& output) {
+    if (jobs == 0) {
+        jobs = std::max<long>(1, sysconf(_SC_NPROCESSORS_ONLN));
+    }
+    uint32_t totalRuns = points.size() * replications;
+    NS_LOG_UNCOND("Balayage: " << points.size() << " points x " << replications
+                  << " réplications, " << jobs << " processus");
+    
+    std::vector<std::vector<SweepAccumulator>> results(points.size(),
+        std::vector<SweepAccumulator>(NUM_QOS_CLASSES));
+    std::map<pid_t, int> running;       // pid -> extrémité de lecture du tube
+    uint32_t nextRun = 0;
+    uint32_t finished = 0;
+    uint32_t failures = 0;
+    
+    while (nextRun < totalRuns || !running.empty()) {
+        while (nextRun < totalRuns && running.size() < jobs) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                NS_FATAL_ERROR("pipe() a échoué");
+            }
+            uint32_t point = nextRun / replications;
+            uint32_t replication = nextRun % replications;
+            std::cout.flush();
+            std::clog.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                NS_FATAL_ERROR("fork() a échoué");
+            }
+            if (pid == 0) {
+                close(fds[0]);
+                RunSweepChild(points[point], point, replication, fds[1]);
+            }
+            close(fds[1]);
+            running[pid] = fds[0];
+            nextRun++;
+        }
+        
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+        
+        // Quelques enregistrements par exécution : ils tiennent dans le tampon du tube
+        SweepSample sample;
+        while (read(it->second, &sample, sizeof(sample)) == sizeof(sample)) {
+            if (!sample.valid) continue;
+            SweepAccumulator& acc = results[sample.point][sample.qosClass];
+            acc.lossRate.push_back(sample.lossRate);
+            acc.avgDelay.push_back(sample.avgDelay);
+            acc.avgJitter.push_back(sample.avgJitter);
+            acc.throughput.push_back(sample.throughput);
+        }
+        close(it->second);
+        running.erase(it);
+        
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failures++;
+        }
+        finished++;
+        if (finished % jobs == 0 || finished == totalRuns) {
+            NS_LOG_UNCOND("  " << finished << "/" << totalRuns << " exécutions terminées");
+        }
+    }
+    
+    std::ofstream file(output);
+    file << "QoS,Congestion,Clients_VoIP,Clients_FTP,Classe,N,";
+    file << "Delai_ms,Delai_IC95,Gigue_ms,Gigue_IC95,Perte_%,Perte_IC95,Debit_Mbps,Debit_IC95\n";
+    
+    NS_LOG_UNCOND("\n QoS Cong VoIP  FTP  Classe  N    Délai (ms)       Gigue (ms)      "
+                  "Perte (%)        Débit (Mbps)");
+    for (uint32_t p = 0; p < points.size(); p++) {
+        const ScenarioConfig& config = points[p];
+        for (uint32_t c = 0; c < NUM_QOS_CLASSES; c++) {
+            const SweepAccumulator& acc = results[p][c];
+            if (acc.avgDelay.empty()) continue;
+            
+            double delay, jitter, loss, throughput;
+            double delayCi = ConfidenceHalfWidth(acc.avgDelay, delay);
+            double jitterCi = ConfidenceHalfWidth(acc.avgJitter, jitter);
+            double lossCi = ConfidenceHalfWidth(acc.lossRate, loss);
+            double throughputCi = ConfidenceHalfWidth(acc.throughput, throughput);
+            
+            char buffer[256];
+            snprintf(buffer, sizeof(buffer),
+                     " %3d %4d %4u %4u  %-6s %3zu  %6.2f ± %-6.2f  %6.2f ± %-6.2f  "
+                     "%6.2f ± %-6.2f  %6.2f ± %-6.2f",
+                     config.enableQos, config.enableCongestion, config.voipClients,
+                     config.ftpClients, QosMetricsCollector::ClassName(QosClass(c)),
+                     acc.avgDelay.size(), delay, delayCi, jitter, jitterCi,
+                     loss, lossCi, throughput, throughputCi);
+            NS_LOG_UNCOND(buffer);
+            
+            file << config.enableQos << "," << config.enableCongestion << ","
+                 << config.voipClients << "," << config.ftpClients << ","
+                 << QosMetricsCollector::ClassName(QosClass(c)) << "," << acc.avgDelay.size() << ","
+                 << delay << "," << delayCi << "," << jitter << "," << jitterCi << ","
+                 << loss << "," << lossCi << "," << throughput << "," << throughputCi << "\n";
+        }
+    }
+    file.close();
+    
+    NS_LOG_UNCOND("\nRésultats du balayage exportés vers: " << output);
+    if (failures > 0) {
+        NS_LOG_UNCOND(failures << " exécution(s) en échec");
+    }
+    return failures > 0 ? 1 : 0;
+}
+
+// ========== PROGRAMME PRINCIPAL ==========
+
+int main(int argc, char *argv[]) {
+    
+    ScenarioConfig config;
+    bool sweep = false;
+    std::string sweepQos = "0,1";
+    std::string sweepCongestion = "";
+    std::string sweepVoip = "";
+    std::string sweepFtp = "";
+    uint32_t replications = 5;
+    uint32_t jobs = 0;
+    std::string sweepOutput = "qos-sweep.csv";
+    
+    CommandLine cmd;
+    cmd.AddValue("enableQos", "Activer QoS (priority queuing)", config.enableQos);
+    cmd.AddValue("enableCongestion", "Créer une congestion du lien", config.enableCongestion);
+    cmd.AddValue("voipClients", "Nombre de clients VoIP", config.voipClients);
+    cmd.AddValue("ftpClients", "Nombre de clients FTP", config.ftpClients);
+    cmd.AddValue("voipCodec", "Codec VoIP: G711, G729 ou Opus", config.voipCodec);
+    cmd.AddValue("ftpPacing", "Émission FTP par seau à jetons (un réveil par rafale)", config.ftpPacing);
+    cmd.AddValue("callGroup", "Multiplexer les appels VoIP dans un seul VoipCallGroup", config.callGroup);
+    cmd.AddValue("onlineMetrics", "Agréger les métriques QoS pendant la simulation", config.onlineMetrics);
+    cmd.AddValue("sampleInterval", "Période d'affichage des métriques en ligne (s, 0 = aucun)", config.sampleInterval);
+    cmd.AddValue("exportFile", "Fichier de séries temporelles par classe (mode en ligne, vide = aucun)", config.exportFile);
+    cmd.AddValue("exportFormat", "Format d'export: rows, columns ou csv", config.exportFormat);
+    cmd.AddValue("exportInterval", "Période d'échantillonnage de l'export (s)", config.exportInterval);
+    cmd.AddValue("eventLog", "Journal d'évènements binaire (voir event-log-print, vide = aucun)", config.eventLog);
+    cmd.AddValue("perfReport", "Rapport d'instrumentation des chemins chauds à la fin", config.perfReport);
+    cmd.AddValue("startJitter", "Décalage aléatoire maximal du démarrage de chaque client (s)", config.startJitter);
+    cmd.AddValue("sweep", "Balayage de paramètres en processus parallèles", sweep);
+    cmd.AddValue("sweepQos", "Valeurs de enableQos à balayer (ex: 0,1)", sweepQos);
+    cmd.AddValue("sweepCongestion", "Valeurs de enableCongestion à balayer (vide = valeur courante)", sweepCongestion);
+    cmd.AddValue("sweepVoip", "Valeurs de voipClients à balayer (ex: 5,10,20)", sweepVoip);
+    cmd.AddValue("sweepFtp", "Valeurs de ftpClients à balayer (ex: 1,3,5)", sweepFtp);
+    cmd.AddValue("replications", "Réplications (graines RNG) par point du balayage", replications);
+    cmd.AddValue("jobs", "Processus simultanés (0 = nombre de cœurs)", jobs);
+    cmd.AddValue("sweepOutput", "Fichier CSV fusionné du balayage", sweepOutput);
+    cmd.AddValue("whatIf", "Variantes après préchauffage: clé=valeur,...;... (qos, impairment)", config.whatIf);
+    cmd.AddValue("warmup", "Mode what-if: durée du préchauffage commun (s)", config.warmup);
+    cmd.AddValue("whatIfPrefix", "Mode what-if: préfixe des métriques et journaux par variante", config.whatIfPrefix);
+    cmd.Parse(argc, argv);
+    
+    Time::SetResolution(Time::NS);
+    
+    if (sweep) {
+        // Grille cartésienne ; une liste vide garde la valeur de la ligne de commande
+        std::vector<uint32_t> qosValues = ParseUintList(sweepQos);
+        std::vector<uint32_t> congestionValues = ParseUintList(sweepCongestion);
+        std::vector<uint32_t> voipValues = ParseUintList(sweepVoip);
+        std::vector<uint32_t> ftpValues = ParseUintList(sweepFtp);
+        if (qosValues.empty()) qosValues.push_back(config.enableQos);
+        if (congestionValues.empty()) congestionValues.push_back(config.enableCongestion);
+        if (voipValues.empty()) voipValues.push_back(config.voipClients);
+        if (ftpValues.empty()) ftpValues.push_back(config.ftpClients);
+        
+        ScenarioConfig base = config;
+        base.sampleInterval = 0;
+        base.exportFile = "";
+        base.eventLog = "";
+        base.perfReport = false;
+        base.whatIf = "";
+        if (base.startJitter <= 0 && !base.callGroup && replications > 1) {
+            NS_LOG_UNCOND("Attention: startJitter=0, les réplications sont identiques (IC95 nuls)");
+        }
+        std::vector<ScenarioConfig> points;
+        for (uint32_t qos : qosValues) {
+            for (uint32_t congestion : congestionValues) {
+                for (uint32_t voip : voipValues) {
+                    for (uint32_t ftp : ftpValues) {
+                        ScenarioConfig point = base;
+                        point.enableQos = qos != 0;
+                        point.enableCongestion = congestion != 0;
+                        point.voipClients = voip;
+                        point.ftpClients = ftp;
+                        points.push_back(point);
+                    }
+                }
+            }
+        }
+        return RunSweep(points, std::max<uint32_t>(replications, 1), jobs, sweepOutput);
+    }
+    
+    if (!config.whatIf.empty()) {
+        // Un fichier ouvert avant le fork serait partagé par toutes les variantes
+        for (const WarmupVariant& variant : WarmupFork::ParseVariants(config.whatIf)) {
+            std::string unknown = variant.FindUnknownKey({"qos", "impairment"});
+            if (!unknown.empty()) {
+                NS_FATAL_ERROR("Clé de variante inconnue: " << unknown);
+            }
+        }
+        if (config.warmup <= 0 || config.warmup >= 30.0) {
+            NS_FATAL_ERROR("Le préchauffage doit être dans ]0, 30[ s");
+        }
+        config.jobs = jobs;
+        config.exportFile = "";
+        config.eventLog = "";
+        QosMetricsCollector collector;
+        return RunScenario(config, collector) > 0 ? 1 : 0;
+    }
+    
+    // Les générateurs et le collecteur de lib/qos-traffic journalisent sous QosTraffic
+    LogComponentEnable("QoSMixedTraffic", LOG_LEVEL_INFO);
+    LogComponentEnable("QosTraffic", LOG_LEVEL_INFO);
+    
+    QosMetricsCollector collector;
+    RunScenario(config, collector);
+    
+    collector.PrintReport();
+    collector.ExportToCsv(config.enableQos ? "qos-metrics-enabled.csv" : "qos-metrics-disabled.csv");
+    
+    return 0;
+}
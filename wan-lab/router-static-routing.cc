@@ -17,6 +17,12 @@
  * - Static routes configured on n0 and n2 to reach each other through n1
  */
 
+#include "lib/anim-trace.h"
+#include "lib/backup-routing.h"
+#include "lib/bench-report.h"
+#include "lib/pcap-ring.h"
+#include "lib/trie-routing.h"
+
 #include "ns3/applications-module.h"
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
@@ -25,6 +31,8 @@
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 
+#include <memory>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TwoNodesWithRouter");
@@ -36,6 +44,26 @@ main(int argc, char* argv[])
     LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
     LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
 
+    // Command line parameters
+    bool autoRoutes = false;
+    bool trieRouting = false;
+    std::string pcapMode = "full";
+    double pcapWindow = 2.0;
+    uint32_t pcapSample = 1;
+    std::string animMode = "xml";
+    CommandLine cmd;
+    cmd.AddValue("autoRoutes",
+                 "Compute the static routes instead of writing them by hand",
+                 autoRoutes);
+    cmd.AddValue("trieRouting",
+                 "Use the longest-prefix-match trie instead of Ipv4StaticRouting",
+                 trieRouting);
+    cmd.AddValue("pcapMode", "full (whole run), ring (around the first echo) or none", pcapMode);
+    cmd.AddValue("pcapWindow", "Ring mode: seconds kept before and after the trigger", pcapWindow);
+    cmd.AddValue("pcapSample", "Capture 1 flow in K", pcapSample);
+    cmd.AddValue("animMode", "xml (NetAnim), binary (see anim-trace-convert) or none", animMode);
+    cmd.Parse(argc, argv);
+
     // Create three nodes: n0 (client), n1 (router), n2 (server)
     NodeContainer nodes;
     nodes.Create(3);
@@ -74,6 +102,10 @@ main(int argc, char* argv[])
 
     // Install Internet stack on all nodes
     InternetStackHelper stack;
+    if (trieRouting)
+    {
+        stack.SetRoutingHelper(Ipv4TrieRoutingHelper());
+    }
     stack.Install(nodes);
 
     // Assign IP addresses to Network 1 (10.1.1.0/24)
@@ -99,29 +131,60 @@ main(int argc, char* argv[])
     // Get static routing protocol helper
     Ipv4StaticRoutingHelper staticRoutingHelper;
 
-    // Configure routing on n0 (client)
-    // n0 needs to know that to reach 10.1.2.0/24, it should go through 10.1.1.2 (router's
-    // interface)
-    Ptr<Ipv4StaticRouting> staticRoutingN0 =
-        staticRoutingHelper.GetStaticRouting(n0->GetObject<Ipv4>());
-    staticRoutingN0->AddNetworkRouteTo(
-        Ipv4Address("10.1.2.0"),   // Destination network
-        Ipv4Mask("255.255.255.0"), // Network mask
-        Ipv4Address("10.1.1.2"),   // Next hop (router's interface on network 1)
-        1                          // Interface index
-    );
-
-    // Configure routing on n2 (server)
-    // n2 needs to know that to reach 10.1.1.0/24, it should go through 10.1.2.1 (router's
-    // interface)
-    Ptr<Ipv4StaticRouting> staticRoutingN2 =
-        staticRoutingHelper.GetStaticRouting(n2->GetObject<Ipv4>());
-    staticRoutingN2->AddNetworkRouteTo(
-        Ipv4Address("10.1.1.0"),   // Destination network
-        Ipv4Mask("255.255.255.0"), // Network mask
-        Ipv4Address("10.1.2.1"),   // Next hop (router's interface on network 2)
-        1                          // Interface index
-    );
+    if (autoRoutes)
+    {
+        // Same routes as below, computed from the topology (no backup exists here)
+        BackupRoutingHelper backupRouting;
+        if (trieRouting)
+        {
+            backupRouting.Install(nodes, &Ipv4TrieRoutingHelper::GetTrieRouting);
+        }
+        else
+        {
+            backupRouting.Install(nodes);
+        }
+        std::cout << "Computed " << backupRouting.GetPrimaryRoutes() << " static routes\n";
+    }
+    else if (trieRouting)
+    {
+        // Same two routes as below, in the trie
+        Ipv4TrieRoutingHelper::GetTrieRouting(n0->GetObject<Ipv4>())
+            ->AddNetworkRouteTo(Ipv4Address("10.1.2.0"),
+                                Ipv4Mask("255.255.255.0"),
+                                Ipv4Address("10.1.1.2"),
+                                1);
+        Ipv4TrieRoutingHelper::GetTrieRouting(n2->GetObject<Ipv4>())
+            ->AddNetworkRouteTo(Ipv4Address("10.1.1.0"),
+                                Ipv4Mask("255.255.255.0"),
+                                Ipv4Address("10.1.2.1"),
+                                1);
+    }
+    else
+    {
+        // Configure routing on n0 (client)
+        // n0 needs to know that to reach 10.1.2.0/24, it should go through 10.1.1.2 (router's
+        // interface)
+        Ptr<Ipv4StaticRouting> staticRoutingN0 =
+            staticRoutingHelper.GetStaticRouting(n0->GetObject<Ipv4>());
+        staticRoutingN0->AddNetworkRouteTo(
+            Ipv4Address("10.1.2.0"),   // Destination network
+            Ipv4Mask("255.255.255.0"), // Network mask
+            Ipv4Address("10.1.1.2"),   // Next hop (router's interface on network 1)
+            1                          // Interface index
+        );
+
+        // Configure routing on n2 (server)
+        // n2 needs to know that to reach 10.1.1.0/24, it should go through 10.1.2.1 (router's
+        // interface)
+        Ptr<Ipv4StaticRouting> staticRoutingN2 =
+            staticRoutingHelper.GetStaticRouting(n2->GetObject<Ipv4>());
+        staticRoutingN2->AddNetworkRouteTo(
+            Ipv4Address("10.1.1.0"),   // Destination network
+            Ipv4Mask("255.255.255.0"), // Network mask
+            Ipv4Address("10.1.2.1"),   // Next hop (router's interface on network 2)
+            1                          // Interface index
+        );
+    }
 
     // Note: Router (n1) doesn't need explicit routes as it's directly connected to both networks
 
@@ -155,31 +218,72 @@ main(int argc, char* argv[])
     clientApps.Stop(Seconds(10.0));
 
     // *** NetAnim Configuration ***
-    AnimationInterface anim("scratch/router-static-routing.xml");
-
     // Node positions are already set via MobilityModel above
     // NetAnim will automatically use the mobility model positions
-
-    // Set node descriptions
-    anim.UpdateNodeDescription(n0, "Client\n10.1.1.1");
-    anim.UpdateNodeDescription(n1, "Router\n10.1.1.2 | 10.1.2.1");
-    anim.UpdateNodeDescription(n2, "Server\n10.1.2.2");
-
-    // Set node colors
-    anim.UpdateNodeColor(n0, 0, 255, 0);   // Green for client
-    anim.UpdateNodeColor(n1, 255, 255, 0); // Yellow for router
-    anim.UpdateNodeColor(n2, 0, 0, 255);   // Blue for server
+    auto describeNodes = [&](auto& animation) {
+        // Set node descriptions
+        animation.UpdateNodeDescription(n0, "Client\n10.1.1.1");
+        animation.UpdateNodeDescription(n1, "Router\n10.1.1.2 | 10.1.2.1");
+        animation.UpdateNodeDescription(n2, "Server\n10.1.2.2");
+
+        // Set node colors
+        animation.UpdateNodeColor(n0, 0, 255, 0);   // Green for client
+        animation.UpdateNodeColor(n1, 255, 255, 0); // Yellow for router
+        animation.UpdateNodeColor(n2, 0, 0, 255);   // Blue for server
+    };
+
+    // Binary mode writes a compact trace; anim-trace-convert makes the XML
+    std::string animFile = "scratch/router-static-routing.xml";
+    std::unique_ptr<AnimationInterface> anim;
+    BinaryAnimTrace binaryAnim;
+    if (animMode == "binary")
+    {
+        animFile = "scratch/router-static-routing.nabt";
+        if (!binaryAnim.Open(animFile, true))
+        {
+            NS_FATAL_ERROR("Cannot open " << animFile);
+        }
+        binaryAnim.Install(nodes);
+        describeNodes(binaryAnim);
+    }
+    else if (animMode == "xml")
+    {
+        anim.reset(new AnimationInterface(animFile));
+        describeNodes(*anim);
+    }
+    else
+    {
+        animFile = "(none)";
+    }
 
     // Enable PCAP tracing on all devices for Wireshark analysis
-    p2p.EnablePcapAll("scratch/router-static-routing");
+    // Ring mode only writes the seconds around the first echo (ARP + routing)
+    PcapRingCapture pcapRing("scratch/router-static-routing");
+    if (pcapMode == "ring")
+    {
+        LogComponentEnable("PcapRingCapture", LOG_LEVEL_INFO);
+        pcapRing.SetWindow(Seconds(pcapWindow), 4 * 1024 * 1024);
+        pcapRing.SetPostTrigger(Seconds(pcapWindow));
+        pcapRing.SetSampling(pcapSample);
+        pcapRing.Install(link1Devices);
+        pcapRing.Install(link2Devices);
+        Simulator::Schedule(Seconds(2.0),
+                            [&pcapRing]() { pcapRing.Trigger("first echo request"); });
+    }
+    else if (pcapMode == "full")
+    {
+        p2p.EnablePcapAll("scratch/router-static-routing");
+    }
 
     // Run simulation
     Simulator::Stop(Seconds(11.0));
+    BenchReport::Arm();
     Simulator::Run();
+    binaryAnim.Close();
     Simulator::Destroy();
 
     std::cout << "\n=== Simulation Complete ===\n";
-    std::cout << "Animation trace saved to: scratch/router-static-routing.xml\n";
+    std::cout << "Animation trace saved to: " << animFile << "\n";
     std::cout << "Routing tables saved to: scratch/router-static-routing.routes\n";
     std::cout << "PCAP traces saved to: scratch/router-static-routing-*.pcap\n";
     std::cout << "Open the XML file with NetAnim to visualize the simulation.\n";
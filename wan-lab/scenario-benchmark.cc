@@ -0,0 +1,475 @@
+/*
+ * Reproducible throughput benchmark of the scenarios in this directory
+ *
+ * Runs every scenario at fixed, scaled sizes with a fixed RNG run, without
+ * animation or PCAP output, and collects the measurements each scenario
+ * writes through BenchReport (bench-report.h): wall-clock, simulated events
+ * per second, peak RSS and time to first event. Each point is repeated and
+ * the repetition with the median wall-clock time is kept.
+ *
+ * Results are written as JSON (one result object per line). Given a
+ * baseline produced by an earlier run, every metric that got worse by more
+ * than the threshold is reported and the exit status is 1:
+ *
+ * ./ns3 run "scenario-benchmark --output=bench.json"
+ * ./ns3 run "scenario-benchmark --baseline=bench.json --threshold=0.1"
+ *
+ * Scenarios are started through the launcher (by default ns3 run without
+ * rebuilding), so the numbers include process startup as a sweep sees it.
+ */
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ScenarioBenchmark");
+
+namespace
+{
+
+struct ScenarioScale
+{
+    std::string scale;
+    std::string args;
+};
+
+struct Scenario
+{
+    std::string name;
+    std::string program;
+    std::string commonArgs; // No animation, no PCAP
+    std::vector<ScenarioScale> scales;
+};
+
+const std::vector<Scenario>&
+GetScenarios()
+{
+    static const std::vector<Scenario> scenarios = {
+        {"router-static-routing",
+         "router-static-routing",
+         "--pcapMode=none --animMode=none",
+         {{"small", ""}}}, // Fixed three-node topology
+        {"triangular-wan",
+         "triangular-wan",
+         "--enableAnimation=false --enablePcap=false",
+         {{"small", "--sites=3"},
+          {"medium", "--sites=16 --topology=partial-mesh --meshDegree=4 --clientSites=8"},
+          {"large",
+           "--sites=64 --topology=partial-mesh --meshDegree=4 --linkPrefix=30 --clientSites=32"}}},
+        {"qos-mix",
+         "qos-mixed-traffic",
+         "--sampleInterval=0",
+         {{"small", "--voipClients=5 --ftpClients=3"},
+          {"medium", "--voipClients=20 --ftpClients=10"},
+          {"large", "--voipClients=80 --ftpClients=40"}}},
+        {"pbr-sdwan",
+         "pbr-simulation",
+         "--pcapMode=none",
+         {{"small", "--simulationTime=30"},
+          {"medium", "--simulationTime=60"},
+          {"large", "--simulationTime=120"}}},
+    };
+    return scenarios;
+}
+
+struct BenchResult
+{
+    std::string scenario;
+    std::string scale;
+    std::string args;
+    bool ok = false;
+    double wallMs = 0;
+    double setupMs = 0;
+    double firstEventMs = 0;
+    double runMs = 0;
+    double events = 0;
+    double eventsPerSec = 0;
+    double simSeconds = 0;
+    double peakRssKb = 0;
+};
+
+std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool
+Contains(const std::vector<std::string>& items, const std::string& item)
+{
+    return items.empty() || std::find(items.begin(), items.end(), item) != items.end();
+}
+
+// Value of "key": in a single-line JSON object written by this file or by
+// BenchReport; both only use flat numbers and strings without escapes
+bool
+ExtractNumber(const std::string& line, const std::string& key, double& value)
+{
+    std::size_t pos = line.find("\"" + key + "\":");
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    value = std::strtod(line.c_str() + pos + key.size() + 3, nullptr);
+    return true;
+}
+
+bool
+ExtractString(const std::string& line, const std::string& key, std::string& value)
+{
+    std::size_t pos = line.find("\"" + key + "\": \"");
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    std::size_t begin = pos + key.size() + 5;
+    std::size_t end = line.find('"', begin);
+    value = line.substr(begin, end - begin);
+    return end != std::string::npos;
+}
+
+// Runs the command with its output discarded; returns the wall-clock time
+bool
+RunCommand(const std::string& command, const std::string& reportPath, double& wallMs)
+{
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        return false;
+    }
+    if (pid == 0)
+    {
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        setenv("NS3_BENCH_REPORT", reportPath.c_str(), 1);
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                 .count();
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+BenchResult
+RunPoint(const std::string& launcher,
+         const Scenario& scenario,
+         const ScenarioScale& scale,
+         uint32_t repetitions,
+         const std::string& reportPath)
+{
+    BenchResult point;
+    point.scenario = scenario.name;
+    point.scale = scale.scale;
+    point.args = scenario.commonArgs + (scale.args.empty() ? "" : " ") + scale.args;
+
+    std::string command =
+        launcher + " '" + scenario.program + " " + point.args + " --RngRun=1'";
+    std::vector<BenchResult> runs;
+    for (uint32_t r = 0; r < repetitions; r++)
+    {
+        std::remove(reportPath.c_str());
+        BenchResult run = point;
+        if (!RunCommand(command, reportPath, run.wallMs))
+        {
+            std::cerr << "  " << scenario.name << "/" << scale.scale << ": command failed: "
+                      << command << "\n";
+            continue;
+        }
+        std::ifstream report(reportPath);
+        std::string line;
+        if (!std::getline(report, line) || !ExtractNumber(line, "runMs", run.runMs))
+        {
+            std::cerr << "  " << scenario.name << "/" << scale.scale
+                      << ": no BenchReport written\n";
+            continue;
+        }
+        ExtractNumber(line, "setupMs", run.setupMs);
+        ExtractNumber(line, "firstEventMs", run.firstEventMs);
+        ExtractNumber(line, "events", run.events);
+        ExtractNumber(line, "simSeconds", run.simSeconds);
+        ExtractNumber(line, "peakRssKb", run.peakRssKb);
+        run.eventsPerSec = run.runMs > 0 ? run.events / (run.runMs / 1000.0) : 0;
+        run.ok = true;
+        runs.push_back(run);
+    }
+    std::remove(reportPath.c_str());
+
+    if (runs.empty())
+    {
+        return point;
+    }
+    std::sort(runs.begin(), runs.end(), [](const BenchResult& a, const BenchResult& b) {
+        return a.wallMs < b.wallMs;
+    });
+    return runs[runs.size() / 2];
+}
+
+void
+WriteResults(const std::string& filename, const std::vector<BenchResult>& results)
+{
+    std::ofstream out(filename);
+    out << "{\"version\": 1, \"results\": [\n";
+    char line[512];
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult& r = results[i];
+        std::snprintf(line,
+                      sizeof(line),
+                      "{\"scenario\": \"%s\", \"scale\": \"%s\", \"args\": \"%s\", "
+                      "\"wallMs\": %.3f, \"setupMs\": %.3f, \"firstEventMs\": %.3f, "
+                      "\"runMs\": %.3f, \"events\": %.0f, \"eventsPerSec\": %.1f, "
+                      "\"simSeconds\": %.3f, \"peakRssKb\": %.0f}%s\n",
+                      r.scenario.c_str(),
+                      r.scale.c_str(),
+                      r.args.c_str(),
+                      r.wallMs,
+                      r.setupMs,
+                      r.firstEventMs,
+                      r.runMs,
+                      r.events,
+                      r.eventsPerSec,
+                      r.simSeconds,
+                      r.peakRssKb,
+                      i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "]}\n";
+}
+
+std::map<std::string, BenchResult>
+ReadBaseline(const std::string& filename)
+{
+    std::map<std::string, BenchResult> baseline;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        BenchResult r;
+        if (!ExtractString(line, "scenario", r.scenario) ||
+            !ExtractString(line, "scale", r.scale))
+        {
+            continue;
+        }
+        ExtractNumber(line, "wallMs", r.wallMs);
+        ExtractNumber(line, "firstEventMs", r.firstEventMs);
+        ExtractNumber(line, "events", r.events);
+        ExtractNumber(line, "eventsPerSec", r.eventsPerSec);
+        ExtractNumber(line, "peakRssKb", r.peakRssKb);
+        r.ok = true;
+        baseline[r.scenario + "/" + r.scale] = r;
+    }
+    return baseline;
+}
+
+// Relative change in the "worse" direction: positive means a regression
+double
+Worsening(double baseline, double current, bool higherIsBetter)
+{
+    if (baseline <= 0)
+    {
+        return 0;
+    }
+    return higherIsBetter ? (baseline - current) / baseline : (current - baseline) / baseline;
+}
+
+uint32_t
+CompareWithBaseline(const std::vector<BenchResult>& results,
+                    const std::map<std::string, BenchResult>& baseline,
+                    double threshold)
+{
+    struct Metric
+    {
+        const char* name;
+        double BenchResult::*field;
+        bool higherIsBetter;
+    };
+
+    const Metric metrics[] = {
+        {"wallMs", &BenchResult::wallMs, false},
+        {"eventsPerSec", &BenchResult::eventsPerSec, true},
+        {"firstEventMs", &BenchResult::firstEventMs, false},
+        {"peakRssKb", &BenchResult::peakRssKb, false},
+    };
+
+    uint32_t regressions = 0;
+    std::cout << "\nComparison with baseline (threshold " << threshold * 100 << " %)\n";
+    for (const BenchResult& r : results)
+    {
+        // A point that no longer runs is the worst regression of all
+        if (!r.ok)
+        {
+            std::cout << "  REGRESSION " << r.scenario << "/" << r.scale << ": run failed\n";
+            regressions++;
+            continue;
+        }
+        auto it = baseline.find(r.scenario + "/" + r.scale);
+        if (it == baseline.end())
+        {
+            continue;
+        }
+        const BenchResult& base = it->second;
+        if (base.events != r.events)
+        {
+            std::cout << "  " << r.scenario << "/" << r.scale << ": event count changed ("
+                      << base.events << " -> " << r.events
+                      << "), the scenario itself differs from the baseline\n";
+        }
+        for (const Metric& metric : metrics)
+        {
+            double change = Worsening(base.*metric.field, r.*metric.field, metric.higherIsBetter);
+            if (change > threshold)
+            {
+                char line[256];
+                std::snprintf(line,
+                              sizeof(line),
+                              "  REGRESSION %s/%s %s: %.1f -> %.1f (%+.1f %%)\n",
+                              r.scenario.c_str(),
+                              r.scale.c_str(),
+                              metric.name,
+                              base.*metric.field,
+                              r.*metric.field,
+                              100.0 * change);
+                std::cout << line;
+                regressions++;
+            }
+        }
+    }
+    if (regressions == 0)
+    {
+        std::cout << "  no regression\n";
+    }
+    return regressions;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string launcher = "./ns3 run --no-build";
+    std::string scenarios = "";
+    std::string scales = "small,medium,large";
+    uint32_t repetitions = 3;
+    std::string output = "scratch/benchmark.json";
+    std::string baseline = "";
+    double threshold = 0.10;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("launcher", "Command prefix used to start a scenario", launcher);
+    cmd.AddValue("scenarios", "Comma-separated scenario names (empty = all)", scenarios);
+    cmd.AddValue("scales", "Comma-separated sizes: small, medium, large", scales);
+    cmd.AddValue("repetitions", "Runs per point (the median wall-clock is kept)", repetitions);
+    cmd.AddValue("output", "JSON results file", output);
+    cmd.AddValue("baseline", "JSON results of a reference run to compare with", baseline);
+    cmd.AddValue("threshold", "Relative worsening reported as a regression", threshold);
+    cmd.Parse(argc, argv);
+
+    std::vector<std::string> scenarioFilter = SplitList(scenarios);
+    std::vector<std::string> scaleFilter = SplitList(scales);
+    std::string reportPath = output + ".run";
+
+    std::vector<BenchResult> results;
+    for (const Scenario& scenario : GetScenarios())
+    {
+        if (!Contains(scenarioFilter, scenario.name))
+        {
+            continue;
+        }
+        for (const ScenarioScale& scale : scenario.scales)
+        {
+            if (!Contains(scaleFilter, scale.scale))
+            {
+                continue;
+            }
+            std::cout << "Running " << scenario.name << "/" << scale.scale << "..." << std::endl;
+            results.push_back(RunPoint(launcher,
+                                       scenario,
+                                       scale,
+                                       std::max<uint32_t>(repetitions, 1),
+                                       reportPath));
+        }
+    }
+
+    char line[256];
+    std::snprintf(line,
+                  sizeof(line),
+                  "\n%-22s %-7s %10s %10s %12s %12s %10s\n",
+                  "scenario",
+                  "scale",
+                  "wall ms",
+                  "1st ev ms",
+                  "events",
+                  "events/s",
+                  "RSS kB");
+    std::cout << line;
+    for (const BenchResult& r : results)
+    {
+        if (!r.ok)
+        {
+            std::snprintf(line,
+                          sizeof(line),
+                          "%-22s %-7s %10s\n",
+                          r.scenario.c_str(),
+                          r.scale.c_str(),
+                          "failed");
+        }
+        else
+        {
+            std::snprintf(line,
+                          sizeof(line),
+                          "%-22s %-7s %10.1f %10.1f %12.0f %12.0f %10.0f\n",
+                          r.scenario.c_str(),
+                          r.scale.c_str(),
+                          r.wallMs,
+                          r.firstEventMs,
+                          r.events,
+                          r.eventsPerSec,
+                          r.peakRssKb);
+        }
+        std::cout << line;
+    }
+
+    WriteResults(output, results);
+    std::cout << "Results: " << output << "\n";
+
+    if (!baseline.empty())
+    {
+        std::map<std::string, BenchResult> reference = ReadBaseline(baseline);
+        if (reference.empty())
+        {
+            std::cerr << "No result found in baseline " << baseline << "\n";
+            return 1;
+        }
+        return CompareWithBaseline(results, reference, threshold) > 0 ? 1 : 0;
+    }
+    return 0;
+}